@@ -0,0 +1,91 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+#include "../rule_site_index.h"
+
+bool same_sites(RuleSiteIndex &index, const AEGraph &graph) {
+    auto dc = graph.possible_double_cuts();
+    auto er = graph.possible_erasures();
+    auto de = graph.possible_deiterations();
+    std::sort(dc.begin(), dc.end());
+    std::sort(er.begin(), er.end());
+    std::sort(de.begin(), de.end());
+
+    // the cached counts of the graph are patched in place as well
+    if (graph.count_double_cuts() != static_cast<int>(dc.size()) ||
+        graph.count_erasures() != static_cast<int>(er.size()))
+        return false;
+
+    return index.possible_double_cuts() == dc &&
+        index.possible_erasures() == er &&
+        index.possible_deiterations() == de;
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "([[A]], [[P], B])",
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]])",
+        "([A, B], [[A, B], C], [[[A, B]]])"
+    };
+
+    std::cerr << "==================== Test 10 ==================\n";
+    std::cerr << "Testing RuleSiteIndex...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+        RuleSiteIndex index(graph);
+        bool ok = same_sites(index, graph);
+
+        // walk down a few steps, always taking the first site of each
+        // rule in turn, then undo everything
+        int applied = 0;
+        for (int step = 0; ok && step < 6; step++) {
+            auto dc = index.possible_double_cuts();
+            auto de = index.possible_deiterations();
+            auto er = index.possible_erasures();
+            if (step % 3 == 0 && !dc.empty()) {
+                index.double_cut(dc[0]);
+            } else if (step % 3 == 1 && !de.empty()) {
+                index.deiterate(de.back());
+            } else if (!er.empty()) {
+                index.erase(er[er.size() / 2]);
+            } else {
+                break;
+            }
+            applied++;
+
+            auto sorted = graph;
+            sorted.sort();
+            ok = sorted.repr() == graph.repr() &&
+                sorted.hash() == graph.hash() && same_sites(index, graph);
+        }
+
+        while (ok && applied--) {
+            ok = index.undo() && same_sites(index, graph);
+        }
+        ok = ok && graph.repr() == AEGraph(input_strs[i]).repr();
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+int main() {
+    std::vector<std::string> input_strs {
+        "([[A]], [[P], B])",
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]])",
+        "([A, B], [[A, B], C], [[[A, B]]])"
+    };
+
+    std::cerr << "==================== Test 11 ==================\n";
+    std::cerr << "Testing stable node ids...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+        bool ok = true;
+
+        // every site translates to an id and back to the same path
+        auto sites = graph.possible_erasures();
+        auto ids = graph.node_ids(sites);
+        auto paths = graph.node_paths();
+        for (size_t k = 0; k < sites.size(); k++) {
+            std::vector<int> where;
+            ok = ok && graph.find_node(ids[k], where) && where == sites[k] &&
+                paths[ids[k]] == sites[k];
+        }
+
+        // after erasing the first site, the other ids still name the same
+        // elements even though their paths shifted
+        if (!sites.empty()) {
+            auto next = graph.erase_node(ids[0]);
+            for (size_t k = 1; k < sites.size(); k++) {
+                std::vector<int> where;
+                bool inside = sites[k].size() > sites[0].size() &&
+                    std::equal(sites[0].begin(), sites[0].end(),
+                        sites[k].begin());
+                if (inside) {
+                    ok = ok && !next.find_node(ids[k], where);
+                    continue;
+                }
+                ok = ok && next.find_node(ids[k], where);
+                ok = ok && next.node_id(where) == ids[k];
+
+                // the rule by id and the rule by the current path agree
+                ok = ok && next.erase_node(ids[k]).repr() ==
+                    next.erase(where).repr();
+            }
+        }
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
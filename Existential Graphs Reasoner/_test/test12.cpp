@@ -0,0 +1,110 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+AEGraph apply_one_by_one(AEGraph graph, std::vector<RuleStep> steps) {
+    // reference: the same steps, by id, double cuts first
+    std::stable_sort(steps.begin(), steps.end(),
+        [](const RuleStep& a, const RuleStep& b) {
+            return a.first == "DC" && b.first != "DC";
+        });
+    auto ids = graph.node_ids([&]() {
+        std::vector<std::vector<int>> paths;
+        for (auto &step : steps)
+            paths.push_back(step.second);
+        return paths;
+    }());
+
+    for (size_t k = 0; k < steps.size(); k++) {
+        if (steps[k].first == "DC")
+            graph = graph.double_cut_node(ids[k]);
+        else if (steps[k].first == "E")
+            graph = graph.erase_node(ids[k]);
+        else
+            graph = graph.deiterate_node(ids[k]);
+    }
+    return graph;
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "([[A]], [[P], B])",
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, F]]]])"
+    };
+
+    std::cerr << "==================== Test 12 ==================\n";
+    std::cerr << "Testing apply_batch()...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+        bool ok = true;
+
+        // greedily collect as many independent steps as possible
+        std::vector<RuleStep> candidates, batch;
+        for (auto &where : graph.possible_double_cuts())
+            candidates.push_back({"DC", where});
+        for (auto &where : graph.possible_deiterations())
+            candidates.push_back({"DE", where});
+        for (auto &where : graph.possible_erasures())
+            candidates.push_back({"E", where});
+        for (auto &step : candidates) {
+            batch.push_back(step);
+            if (!graph.valid_batch(batch))
+                batch.pop_back();
+        }
+
+        auto res = graph.apply_batch(batch);
+        auto ref = apply_one_by_one(graph, batch);
+        auto sorted = res;
+        sorted.sort();
+        ok = batch.size() > 1 && res.repr() == ref.repr() &&
+            res.repr() == sorted.repr() && res.hash() == sorted.hash();
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Expected: " << ref.repr() << std::endl;
+            std::cerr << "Got: " << res.repr() << std::endl;
+        }
+    }
+
+    // conflicting batches are rejected; the graphs are (A, [A, B, C], [[D]])
+    // and (A, B, [A, B]) in canonical order
+    std::vector<std::pair<AEGraph, std::vector<RuleStep>>> invalid = {
+        // erases the area of the other step
+        {AEGraph("([A, B, C], [[D]], A)"), {{"E", {0}}, {"DE", {0, 0}}}},
+        // erases the original of the deiterated A
+        {AEGraph("([A, B, C], [[D]], A)"), {{"E", {2}}, {"DE", {0, 0}}}},
+        // the same step twice
+        {AEGraph("([A, B, C], [[D]], A)"), {{"DC", {1}}, {"DC", {1}}}},
+        // not a site at all
+        {AEGraph("([A, B, C], [[D]], A)"), {{"E", {0, 1}}}},
+        // each step is legal, but together they empty the cut
+        {AEGraph("([A, B], A, B)"), {{"DE", {0, 0}}, {"DE", {0, 1}}}}
+    };
+    for (auto &entry : invalid) {
+        if (entry.first.valid_batch(entry.second)) {
+            total = 0;
+            std::cerr << "Accepted an invalid batch on " << entry.first
+                << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+int main() {
+    std::vector<std::pair<std::string, std::string>> input_strs {
+        {"(A)", "([[A]])"},
+        {"(p, [p, [q]])", "(q)"},
+        {"(P, Q, R, [[A], [B]])", "(P, A, B)"},
+        {"([[B], A], C, [D])", "([C, [A]], B, [[D]])"},
+        {"()", "([X], Y)"}
+    };
+
+    std::cerr << "==================== Test 13 ==================\n";
+    std::cerr << "Testing juxtapose(), enclose() and counterset()...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph premise(input_strs[i].first);
+        AEGraph conclusion(input_strs[i].second);
+
+        auto both = AEGraph::juxtapose(premise, conclusion);
+        auto counter = AEGraph::counterset(premise, conclusion);
+
+        std::string prem = premise.repr().substr(1, premise.repr().size() - 2);
+        std::string conc = conclusion.repr().substr(1,
+            conclusion.repr().size() - 2);
+        std::string sep = prem.empty() || conc.empty() ? "" : ", ";
+        AEGraph ref_both("(" + prem + sep + conc + ")");
+        AEGraph ref_counter("(" + prem + (prem.empty() ? "" : ", ") +
+            "[" + conc + "])");
+
+        bool ok = both.repr() == ref_both.repr() &&
+            both.hash() == ref_both.hash() &&
+            counter.repr() == ref_counter.repr() &&
+            counter.hash() == ref_counter.hash() &&
+            AEGraph::enclose(premise).repr() ==
+                "([" + prem + "])";
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Expected: " << ref_counter.repr() << std::endl;
+            std::cerr << "Got: " << counter.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+bool check(const AEGraph &graph) {
+    auto dc = graph.possible_double_cuts();
+    auto er = graph.possible_erasures();
+    auto de = graph.possible_deiterations();
+    std::sort(dc.begin(), dc.end());
+    std::sort(er.begin(), er.end());
+    std::sort(de.begin(), de.end());
+
+    if (graph.count_double_cuts() != static_cast<int>(dc.size()) ||
+        graph.count_erasures() != static_cast<int>(er.size()) ||
+        graph.count_deiterations() != static_cast<int>(de.size()))
+        return false;
+
+    for (size_t k = 0; k < dc.size(); k++)
+        if (graph.nth_double_cut(k) != dc[k])
+            return false;
+    for (size_t k = 0; k < er.size(); k++)
+        if (graph.nth_erasure(k) != er[k])
+            return false;
+    for (size_t k = 0; k < de.size(); k++)
+        if (graph.nth_deiteration(k) != de[k])
+            return false;
+
+    return graph.nth_double_cut(dc.size()).empty() &&
+        graph.nth_erasure(er.size()).empty() &&
+        graph.nth_deiteration(de.size()).empty();
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[A]]], B)",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, F]]]], [A, B])"
+    };
+
+    std::cerr << "==================== Test 14 ==================\n";
+    std::cerr << "Testing site counting and unranking...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+
+        // the cached counts must also follow the rules
+        bool ok = check(graph);
+        for (auto &where : graph.possible_double_cuts())
+            ok = ok && check(graph.double_cut(where));
+        for (auto &where : graph.possible_erasures())
+            ok = ok && check(graph.erase(where));
+        for (auto &where : graph.possible_deiterations())
+            ok = ok && check(graph.deiterate(where));
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
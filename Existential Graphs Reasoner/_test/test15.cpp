@@ -0,0 +1,67 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+bool sorted_sites(const AEGraph &graph) {
+    auto dc = graph.possible_double_cuts();
+    auto er = graph.possible_erasures();
+    auto de = graph.possible_deiterations();
+    return std::is_sorted(dc.begin(), dc.end()) &&
+        std::is_sorted(er.begin(), er.end()) &&
+        std::is_sorted(de.begin(), de.end());
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, F]]]], [A, B])",
+        "(A, A, [B], [[B], A, [A, [B]]], [[A, [[B]]]])"
+    };
+
+    // deiteration sites of the last graph, in the expected order
+    // ([B], [[B], [[B], A], A], [[[[B]], A]], A, A) in canonical order
+    std::vector<std::vector<int>> ref = {
+        {1, 0}, {1, 1, 0}, {1, 1, 1}, {1, 1, 1}, {1, 2}, {1, 2},
+        {2, 0, 1}, {2, 0, 1}
+    };
+
+    std::cerr << "==================== Test 15 ==================\n";
+    std::cerr << "Testing the order of the rule sites...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+
+        bool ok = sorted_sites(graph);
+        for (auto &where : graph.possible_double_cuts())
+            ok = ok && sorted_sites(graph.double_cut(where));
+        for (auto &where : graph.possible_erasures())
+            ok = ok && sorted_sites(graph.erase(where));
+        for (auto &where : graph.possible_deiterations())
+            ok = ok && sorted_sites(graph.deiterate(where));
+        if (i + 1 == len)
+            ok = ok && graph.possible_deiterations() == ref;
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+void measure(const AEGraph &graph, int level, int &size, int &depth,
+    int &atoms) {
+    // reference values, recomputed from scratch
+    size += graph.size();
+    atoms += graph.num_atoms();
+    depth = std::max(depth, level);
+    for (auto &sg : graph.subgraphs)
+        measure(sg, level + 1, size, depth, atoms);
+}
+
+bool check(const AEGraph &before, const AEGraph &after, StepEffect effect) {
+    int size = 0, depth = 0, atoms = 0;
+    measure(after, 0, size, depth, atoms);
+    return after.total_size() == size && after.depth() == depth &&
+        after.total_atoms() == atoms &&
+        effect.size == after.total_size() - before.total_size() &&
+        effect.depth == after.depth() - before.depth() &&
+        effect.atoms == after.total_atoms() - before.total_atoms();
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[A]]], B)",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, [F]]]]], [A, B])"
+    };
+
+    std::cerr << "==================== Test 16 ==================\n";
+    std::cerr << "Testing step effect prediction...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+
+        bool ok = check(graph, graph, {0, 0, 0});
+        for (auto &where : graph.possible_double_cuts())
+            ok = ok && check(graph, graph.double_cut(where),
+                graph.step_effect({"DC", where}));
+        for (auto &where : graph.possible_erasures())
+            ok = ok && check(graph, graph.erase(where),
+                graph.step_effect({"E", where}));
+        for (auto &where : graph.possible_deiterations())
+            ok = ok && check(graph, graph.deiterate(where),
+                graph.step_effect({"DE", where}));
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
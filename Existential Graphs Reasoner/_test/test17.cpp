@@ -0,0 +1,97 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+// deeper than the default stack allows for one call per nesting level
+const int kDepth = 100000;
+
+std::string repeat(const std::string &s, int times) {
+    std::string result;
+    for (int i = 0; i < times; i++)
+        result += s;
+    return result;
+}
+
+bool same_as_parsed(const AEGraph &graph) {
+    // the sums kept up to date by the rules must match a fresh parse
+    AEGraph parsed(graph.repr());
+    return parsed.hash() == graph.hash() &&
+        parsed.total_size() == graph.total_size() &&
+        parsed.total_atoms() == graph.total_atoms() &&
+        parsed.depth() == graph.depth() &&
+        parsed.count_double_cuts() == graph.count_double_cuts() &&
+        parsed.count_erasures() == graph.count_erasures();
+}
+
+bool check(const std::string &input, int depth, int atom_paths) {
+    AEGraph graph(input);
+    bool ok = graph.repr() == input && graph.depth() == depth;
+
+    AEGraph copy = graph;
+    ok = ok && copy == graph && copy.hash() == graph.hash();
+    copy = AEGraph("()");
+    copy = graph;
+    copy.sort();
+    ok = ok && copy.repr() == input && copy.hash() == graph.hash();
+
+    ok = ok && graph.contains("p") && !graph.contains("z") &&
+        static_cast<int>(graph.get_paths_to("r").size()) == atom_paths;
+
+    int count = graph.count_double_cuts();
+    if (count > 0) {
+        ok = ok && same_as_parsed(graph.double_cut(graph.nth_double_cut(0)))
+            && same_as_parsed(graph.double_cut(
+                graph.nth_double_cut(count - 1)));
+    }
+    count = graph.count_erasures();
+    if (count > 0) {
+        ok = ok && same_as_parsed(graph.erase(graph.nth_erasure(count - 1)));
+    }
+    count = graph.count_deiterations();
+    if (count > 0) {
+        std::vector<int> where = graph.nth_deiteration(count - 1);
+        ok = ok && same_as_parsed(graph.deiterate(where)) &&
+            same_as_parsed(graph.apply_batch({{"DE", where}}));
+    }
+    return ok;
+}
+
+int main() {
+    // cuts nested kDepth deep, in canonical form
+    std::vector<std::string> input_strs {
+        "(" + repeat("[", kDepth) + "p" + repeat("]", kDepth) + ")",
+        "(" + repeat("[", kDepth) + "q, r]" + repeat(", p]", kDepth - 1) +
+            ", p)",
+        "(" + repeat("[", kDepth) + "q, r]" + repeat(", p]", kDepth - 1) +
+            ", [q])",
+        "(" + repeat("[[", kDepth / 2) + "p, r" + repeat("], q]", kDepth / 2)
+            + ", q)",
+        "(" + repeat("[", kDepth) + "p" + repeat("]", kDepth) + ", " +
+            repeat("[", kDepth) + "q, r]" + repeat(", p]", kDepth - 1) + ")"
+    };
+    std::vector<int> depths = {kDepth, kDepth, kDepth, kDepth, kDepth};
+    // paths to the atom r, which sits at the bottom of the nesting
+    std::vector<int> atom_paths = {0, 1, 1, 1, 1};
+
+    std::cerr << "==================== Test 17 ==================\n";
+    std::cerr << "Testing graphs nested " << kDepth << " deep...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        if (!check(input_strs[i], depths[i], atom_paths[i])) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
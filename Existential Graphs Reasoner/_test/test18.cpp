@@ -0,0 +1,70 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+bool exact(const AEGraph &graph) {
+    // no buffer keeps room the graph does not use
+    if (graph.subgraphs.capacity() != graph.subgraphs.size() ||
+        graph.atoms.capacity() != graph.atoms.size() ||
+        graph.atom_ids.capacity() != graph.atom_ids.size())
+        return false;
+    for (auto &sg : graph.subgraphs)
+        if (!exact(sg))
+            return false;
+    return true;
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[A]]], B, [[[[C]]], D])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, [F]]]]], [A, B])"
+    };
+
+    std::cerr << "==================== Test 18 ==================\n";
+    std::cerr << "Testing compaction...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+
+        // grow and shrink the graph in place, leaving spare capacity behind
+        graph.insert_subgraph(AEGraph(input_strs[i]).subgraphs[0]);
+        graph.insert_atom("Z");
+        while (graph.count_double_cuts() > 0) {
+            graph.double_cut_helper(graph.nth_double_cut(0), graph);
+        }
+        graph.erase_helper(graph.nth_erasure(graph.count_erasures() - 1),
+            graph);
+
+        std::string before = graph.repr();
+        uint64_t hash = graph.hash();
+        auto paths = graph.node_paths();
+        graph.compact();
+
+        bool ok = exact(graph) && graph.repr() == before &&
+            graph.hash() == hash && graph.node_paths() == paths;
+        for (auto &where : graph.possible_erasures())
+            ok = ok && graph.erase(where).repr() ==
+                AEGraph(before).erase(where).repr();
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
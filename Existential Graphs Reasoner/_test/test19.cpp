@@ -0,0 +1,78 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+#include "../aegraph_engine.h"
+
+template <class Storage>
+bool same_as_aegraph(const std::string &input) {
+    // the engine must find the same sites and build the same graphs
+    AEGraph graph(input);
+    GraphEngine<Storage> engine(input);
+    bool ok = engine.repr() == graph.repr();
+
+    auto dc = graph.possible_double_cuts();
+    auto er = graph.possible_erasures();
+    auto de = graph.possible_deiterations();
+    ok = ok && engine.possible_double_cuts() == dc &&
+        engine.possible_erasures() == er &&
+        engine.possible_erasures(0) == graph.possible_erasures(0) &&
+        engine.possible_deiterations() == de;
+
+    for (auto &where : dc)
+        ok = ok && engine.double_cut(where).repr() ==
+            graph.double_cut(where).repr();
+    for (auto &where : er)
+        ok = ok && engine.erase(where).repr() == graph.erase(where).repr();
+    for (auto &where : de)
+        ok = ok && engine.deiterate(where).repr() ==
+            graph.deiterate(where).repr();
+
+    for (std::string atom : {"A", "B", "p", "q", "Z"})
+        ok = ok && engine.contains(atom) == graph.contains(atom) &&
+            engine.get_paths_to(atom) == graph.get_paths_to(atom);
+    for (auto &sg : graph.subgraphs) {
+        GraphEngine<Storage> other(sg);
+        ok = ok && engine.contains(other) == graph.contains(sg) &&
+            engine.get_paths_to(other) == graph.get_paths_to(sg);
+    }
+    return ok;
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[A]]], B, [[[[B]]], A], [[B]])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]], [q])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, [F]]]]], [A, B])"
+    };
+
+    std::cerr << "==================== Test 19 ==================\n";
+    std::cerr << "Testing the graph engine templates...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        const std::string &input = input_strs[i];
+        bool ok = same_as_aegraph<NestedStorage<StringAtoms>>(input) &&
+            same_as_aegraph<NestedStorage<InternedAtoms>>(input) &&
+            same_as_aegraph<ArenaStorage<StringAtoms>>(input) &&
+            same_as_aegraph<ArenaStorage<InternedAtoms>>(input);
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << input << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
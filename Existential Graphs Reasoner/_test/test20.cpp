@@ -0,0 +1,68 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+#include "../aegraph_literal.h"
+
+// the literals are parsed and sorted by the compiler
+static_assert("([B], [A], C)"_aeg.num_nodes == 3, "two cuts inside the sheet");
+static_assert("([B], [A], C)"_aeg.total_atoms == 3 &&
+    "([B], [A], C)"_aeg.num_atoms[0] == 1, "one atom on the sheet");
+static_assert("(b,a)"_aeg.text[1] == 'a' && "(b,a)"_aeg.length == 6,
+    "canonical text");
+
+template <size_t N>
+bool same_as_parsed(const StaticGraph<N> &literal, const std::string &input) {
+    AEGraph parsed(input);
+    AEGraph graph = literal.graph();
+    return literal.repr() == parsed.repr() && graph == parsed &&
+        graph.hash() == parsed.hash() &&
+        graph.total_size() == parsed.total_size() &&
+        graph.depth() == parsed.depth() &&
+        graph.count_erasures() == parsed.count_erasures() &&
+        graph.possible_deiterations() == parsed.possible_deiterations();
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[A]]], B, [[[[B]]], A], [[B]])",
+        "(D,C , B,A, [A, [C, B], [D, [A, [B]]]])",
+        "(q, p, [[q]], [p, [[s, r]], [q]], [[p, [q]]], [q])",
+        "[ [B, A], [C, [B, A]], [[[B, A]]], [[[[[F], E]]]], [A, B] ]"
+    };
+
+    std::cerr << "==================== Test 20 ==================\n";
+    std::cerr << "Testing compile-time graph literals...\n";
+    std::vector<bool> results {
+        same_as_parsed("(S, [[P]], [A, [B], [[C, D]]])"_aeg, input_strs[0]),
+        same_as_parsed("([[[A]]], B, [[[[B]]], A], [[B]])"_aeg, input_strs[1]),
+        same_as_parsed("(D,C , B,A, [A, [C, B], [D, [A, [B]]]])"_aeg,
+            input_strs[2]),
+        same_as_parsed("(q, p, [[q]], [p, [[s, r]], [q]], [[p, [q]]], [q])"_aeg,
+            input_strs[3]),
+        same_as_parsed(
+            "[ [B, A], [C, [B, A]], [[[B, A]]], [[[[[F], E]]]], [A, B] ]"_aeg,
+            input_strs[4])
+    };
+
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        if (!results[i]) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << input_strs[i] << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
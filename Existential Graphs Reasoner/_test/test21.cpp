@@ -0,0 +1,75 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include "../aegraph.h"
+#include "../graph_pattern.h"
+
+PatternMatch occurrence(std::vector<int> path,
+    std::map<std::string, std::vector<int>> bindings) {
+    PatternMatch m;
+    m.path = path;
+    m.bindings = bindings;
+    return m;
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(A, [A, [A]], [B, [B]], [[C]])",
+        "(A, [A, [A]], [B, [B]], [[C]])",
+        "(A, [A, [A]], [B, [B]], [[C]])",
+        "(A, [A, [A]], [B, [B]], [[C]])",
+        "([A, A, B], [[C], [C]], [[[C]]])"
+    };
+    std::vector<std::string> patterns {
+        "[?X, [?X]]",
+        "[[?Y], ...]",
+        "(?X, [?X, ...], ...)",
+        "[A, ...]",
+        "[?X, ?X, ...]"
+    };
+    // the sheet holds [[A], A], [[B], B] and [[C]], in this order
+    std::vector<std::vector<PatternMatch>> refs {
+        {occurrence({0}, {{"X", {0, 0, 0}}}),
+         occurrence({1}, {{"X", {1, 0, 0}}})},
+        {occurrence({0}, {{"Y", {0, 0, 0}}}),
+         occurrence({1}, {{"Y", {1, 0, 0}}}),
+         occurrence({2}, {{"Y", {2, 0, 0}}})},
+        {occurrence({}, {{"X", {0, 1}}})},
+        {occurrence({0}, {}), occurrence({0, 0}, {})},
+        {occurrence({0}, {{"X", {0, 0}}}),
+         occurrence({1}, {{"X", {1, 0}}})}
+    };
+
+    std::cerr << "==================== Test 21 ==================\n";
+    std::cerr << "Testing pattern matching...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+        GraphPattern pattern(patterns[i]);
+        auto found = pattern.matches(graph);
+        bool ok = found == refs[i];
+
+        // the single cut check agrees with the traversal
+        for (auto &m : found)
+            ok = ok && !pattern.matches_at(graph, m.path).empty();
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+            std::cerr << "Pattern: " << patterns[i] << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
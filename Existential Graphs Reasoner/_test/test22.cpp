@@ -0,0 +1,71 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../graph_pattern.h"
+
+int main() {
+    std::vector<std::string> input_strs {
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[A]]], B, [[[[B]]], A], [[B]], [B])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]], [[p, [q]]], [q])",
+        "([A, B], [[A, B], C], [[[A, B]]], [[[[E, [F]]]]], [A, B])"
+    };
+
+    // every cut of every input, and a few that occur nowhere
+    PatternIndex index;
+    std::vector<AEGraph> patterns;
+    for (auto &input : input_strs) {
+        AEGraph graph(input);
+        for (auto &sg : graph.subgraphs) {
+            patterns.push_back(sg);
+            for (auto &inner : sg.subgraphs)
+                patterns.push_back(inner);
+        }
+    }
+    patterns.push_back(AEGraph("[Z]"));
+    patterns.push_back(AEGraph("[[B]]"));
+    for (auto &pattern : patterns)
+        index.add(pattern);
+
+    std::cerr << "==================== Test 22 ==================\n";
+    std::cerr << "Testing multi-pattern search...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(input_strs[i]);
+
+        // one get_paths_to() call per pattern gives the same occurrences
+        std::vector<std::pair<std::vector<int>, int>> ref;
+        for (size_t p = 0; p < patterns.size(); p++)
+            for (auto &path : graph.get_paths_to(patterns[p]))
+                ref.push_back({path, p});
+        std::sort(ref.begin(), ref.end());
+
+        auto found = index.find_all(graph);
+        bool ok = index.size() == static_cast<int>(patterns.size()) &&
+            found.size() == ref.size();
+        for (size_t k = 0; ok && k < found.size(); k++)
+            ok = found[k].first == ref[k].second &&
+                found[k].second == ref[k].first;
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+#include "../knowledge_base.h"
+
+int main() {
+    std::vector<std::string> premises {
+        "([p, [q]])",
+        "([q, [r]])",
+        "(s)",
+        "([s, [t]])",
+        "([[u]])",
+        "([[]])"
+    };
+
+    // conclusion, number of hops, relevant premises
+    std::vector<std::string> input_strs {
+        "(p)",
+        "(r)",
+        "(r)",
+        "([t], u)",
+        "(w)"
+    };
+    std::vector<int> hops {-1, -1, 0, -1, -1};
+    std::vector<std::vector<int>> output {
+        {0, 1, 5},
+        {0, 1, 5},
+        {1, 5},
+        {2, 3, 4, 5},
+        {5}
+    };
+
+    KnowledgeBase kb;
+    for (auto &premise : premises)
+        kb.add(AEGraph(premise));
+
+    std::cerr << "==================== Test 23 ==================\n";
+    std::cerr << "Testing the premise knowledge base...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph conclusion(input_strs[i]);
+        auto relevant = kb.relevant(conclusion, hops[i]);
+
+        AEGraph premise("()");
+        for (int index : output[i])
+            premise = AEGraph::juxtapose(premise, AEGraph(premises[index]));
+        AEGraph expected = AEGraph::counterset(premise, conclusion);
+
+        bool ok = kb.size() == static_cast<int>(premises.size()) &&
+            kb.premise(1).repr() == "([[r], q])" &&
+            kb.signature(1) == std::vector<std::string>({"q", "r"}) &&
+            relevant == output[i] &&
+            kb.counterset(conclusion, hops[i]).repr() == expected.repr();
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Conclusion: " << conclusion.repr() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
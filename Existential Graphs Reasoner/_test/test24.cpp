@@ -0,0 +1,103 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../knowledge_base.h"
+
+bool valid_proof(const KnowledgeBase& kb, const Proof& proof) {
+    // replays the positional steps on the sorted counterset
+    AEGraph graph = kb.counterset(proof.conclusion);
+    graph.sort();
+    for (size_t k = 0; k + 1 < proof.steps.size(); k++) {
+        const RuleStep &step = proof.steps[k];
+        if (step.first == "DC" && graph.can_double_cut(step.second))
+            graph = graph.double_cut(step.second);
+        else if (step.first == "DE" && graph.can_deiterate(step.second))
+            graph = graph.deiterate(step.second);
+        else if (step.first == "E" && graph.can_erase(step.second))
+            graph = graph.erase(step.second);
+        else
+            return false;
+        graph.sort();
+    }
+    return proof.steps.back().first == "END" && is_contradiction(graph) &&
+        std::includes(proof.premises.begin(), proof.premises.end(),
+            proof.used.begin(), proof.used.end());
+}
+
+int main() {
+    std::vector<std::string> premises {
+        "(p)",
+        "([p, [q]])",
+        "([r, [s]])",
+        "(r)",
+        "(t, [t, [u]])"
+    };
+    std::vector<std::string> conclusions {
+        "(q)",
+        "(s)",
+        "(u)",
+        "(v)",
+        "([[q]])"
+    };
+
+    // the change of every input (a premise to add, or the number of one
+    // to remove), the searches it takes and which conclusions are proved
+    std::vector<std::string> added {"", "([q, [s]])", "", "(v)", "(p)"};
+    std::vector<int> removed {-1, -1, 0, -1, -1};
+    std::vector<int> searches {0, 0, 2, 1, 2};
+    std::vector<std::vector<bool>> proved {
+        {1, 1, 1, 0, 1},
+        {1, 1, 1, 0, 1},
+        {0, 1, 1, 0, 0},
+        {0, 1, 1, 1, 0},
+        {1, 1, 1, 1, 1}
+    };
+
+    KnowledgeBase kb;
+    for (auto &premise : premises)
+        kb.add(AEGraph(premise));
+    for (auto &conclusion : conclusions)
+        kb.prove(AEGraph(conclusion));
+
+    std::cerr << "==================== Test 24 ==================\n";
+    std::cerr << "Testing incremental proofs...\n";
+    size_t len = added.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        if (!added[i].empty())
+            kb.add(AEGraph(added[i]));
+        if (removed[i] >= 0)
+            kb.remove(removed[i]);
+
+        bool ok = kb.revalidate() == searches[i];
+        for (int k = 0; ok && k < kb.num_proofs(); k++) {
+            const Proof &proof = kb.proof(k);
+            AEGraph conclusion(conclusions[k]);
+            bool found = !find_proof(kb.counterset(conclusion)).empty();
+
+            ok = proof.premises == kb.relevant(conclusion) &&
+                found == proved[i][k] && proof.steps.empty() != found &&
+                (!found || valid_proof(kb, proof));
+        }
+        // premises 2, 3 and 5 join the first proof, which still only
+        // uses the first two
+        ok = ok && (i != 1 || kb.proof(0).used == std::vector<int>({0, 1}));
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+#include "../beta_graph.h"
+
+typedef std::vector<std::vector<int>> Paths;
+
+bool canonical_form() {
+    BetaGraph first("([Man(x), [Mortal(x)]], Man(s))");
+    BetaGraph second("(Man(a), [[Mortal(b)], Man(b)])");
+    return first.repr() == "([[Mortal(x1)], Man(x1)], Man(x2))" &&
+        second.repr() == first.repr() && first.num_lines() == 2 &&
+        BetaGraph(first.repr()).repr() == first.repr() &&
+        BetaGraph("(R(x, y, x), [S])").repr() == "([S], R(x1, x2, x1))" &&
+        BetaGraph("(P(x), P(y), Q(x))").repr() ==
+            BetaGraph("(P(y), P(x), Q(x))").repr() &&
+        BetaGraph("(R(a, b), R(b, c), R(c, a), R(d, e), R(e, f), R(f, d))")
+            .repr() == BetaGraph("(R(a, b), R(d, e), R(e, f), R(b, c), "
+                "R(f, d), R(c, a))").repr();
+}
+
+bool syllogism() {
+    // Socrates is a man, every man is mortal, so Socrates is mortal
+    BetaGraph graph("(Man(s), [Man(x), [Mortal(x)]])");
+    bool ok = graph.possible_deiterations().empty() &&
+        graph.can_join({1}, 0, {0, 1}, 0);
+    graph.join({1}, 0, {0, 1}, 0);
+    ok = ok && graph.same_line({1}, 0, {0, 1}, 0) &&
+        graph.possible_deiterations() == Paths({{0, 1}});
+    graph.deiterate({0, 1});
+    ok = ok && graph.possible_double_cuts() == Paths({{0}});
+    graph.double_cut({0});
+    return ok && graph.repr() == "(Man(x1), Mortal(x1))";
+}
+
+bool erasures() {
+    BetaGraph nested("([P(x), [Q(x)]])");
+    BetaGraph outer("(P(x), [Q(x)])");
+    BetaGraph repeated("(P(x), [P(x), Q])");
+    BetaGraph other("(P(x), [P(y), Q])");
+    BetaGraph joined("(R(x, y), [R(z, z), Q])");
+    bool ok = nested.can_sever({0, 0, 0}, 0) && !nested.can_sever({0, 1}, 0) &&
+        !outer.can_sever({1}, 0) && outer.possible_erasures() == Paths({{0}}) &&
+        repeated.possible_deiterations() == Paths({{0, 0}}) &&
+        other.possible_deiterations() == Paths({{0, 0}}) &&
+        joined.possible_deiterations().empty();
+    other.deiterate({0, 0});
+    return ok && other.repr() == "([Q], P(x1))" && other.num_lines() == 1;
+}
+
+bool joins() {
+    BetaGraph inside("([P(a), [Q(b)]])");
+    BetaGraph sheet("(P(a), [Q(b)])");
+    BetaGraph siblings("([P(a)], [Q(b)])");
+    bool ok = !inside.can_join({0, 1}, 0, {0, 0, 0}, 0) &&
+        sheet.can_join({1}, 0, {0, 0}, 0) &&
+        !siblings.can_join({0, 0}, 0, {1, 0}, 0);
+    sheet.join({1}, 0, {0, 0}, 0);
+    return ok && sheet.num_lines() == 1 && sheet.repr() == "([Q(x1)], P(x1))";
+}
+
+bool long_ligature() {
+    // a line through 100000 hooks, joined and then cut apart
+    const int n = 100000;
+    std::string text = "(";
+    for (int i = 0; i < n; i++)
+        text += (i ? ", P(x" : "P(x") + std::to_string(i) + ")";
+    BetaGraph graph(text + ")");
+
+    bool ok = graph.num_lines() == n;
+    for (int i = 1; i < n; i++)
+        graph.join({i - 1}, 0, {i}, 0);
+    ok = ok && graph.num_lines() == 1;
+    for (int i = 0; i < n; i += 2)
+        graph.sever({i}, 0);
+    return ok && graph.num_lines() == n / 2 + 1 &&
+        graph.same_line({1}, 0, {n - 1}, 0) &&
+        !graph.same_line({0}, 0, {2}, 0);
+}
+
+int main() {
+    std::vector<std::string> names {
+        "canonical form",
+        "syllogism",
+        "erasures",
+        "joins",
+        "long ligature"
+    };
+    std::vector<bool (*)()> checks {
+        canonical_form,
+        syllogism,
+        erasures,
+        joins,
+        long_ligature
+    };
+
+    std::cerr << "==================== Test 25 ==================\n";
+    std::cerr << "Testing Beta graphs...\n";
+    size_t len = checks.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        if (!checks[i]()) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Case: " << names[i] << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
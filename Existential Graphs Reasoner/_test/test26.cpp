@@ -0,0 +1,120 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <stdexcept>
+#include "../aegraph.h"
+#include "../formula_io.h"
+
+bool holds(const AEGraph& graph, const std::map<std::string, bool>& value) {
+    // a sheet holds if all of its elements hold, a cut if not all of them
+    bool all = true;
+    for (auto &sg : graph.subgraphs)
+        all = all && holds(sg, value);
+    for (auto &atom : graph.atoms)
+        all = all && value.at(atom);
+    return graph.is_SA ? all : !all;
+}
+
+bool same_models(const AEGraph& graph, const std::string& cnf,
+    const std::vector<std::string>& names) {
+    // the graph holds exactly when some values of the extra variables of
+    // the CNF satisfy it
+    AEGraph clauses = from_dimacs(cnf, names);
+    int atoms = names.size();
+    int variables = std::stoi(cnf.substr(6));
+    for (int mask = 0; mask < (1 << atoms); mask++) {
+        std::map<std::string, bool> value;
+        for (int k = 0; k < atoms; k++)
+            value[names[k]] = mask >> k & 1;
+
+        bool satisfiable = false;
+        for (int extra = 0; extra < (1 << (variables - atoms)); extra++) {
+            for (int k = atoms; k < variables; k++)
+                value["x" + std::to_string(k + 1)] = extra >> (k - atoms) & 1;
+            satisfiable = satisfiable || holds(clauses, value);
+        }
+        if (satisfiable != holds(graph, value))
+            return false;
+    }
+    return true;
+}
+
+int main() {
+    std::vector<std::string> input_strs {
+        "a & b -> c",
+        "!(a | b) <-> !a & !b",
+        "p -> q -> r",
+        "~~a || false",
+        "(x1 | !x2) && (x2 | x3) & !x3 & true"
+    };
+    std::vector<std::string> output {
+        "([[c], a, b])",
+        "([[[[[a], [b]]]], [a], [b]], [[[[a], [b]]], [[a], [b]]])",
+        "([[[[r], q]], p])",
+        "([[[[a]]], [[]]])",
+        "([[[x2]], [x1]], [[x2], [x3]], [x3])"
+    };
+
+    std::cerr << "==================== Test 26 ==================\n";
+    std::cerr << "Testing infix and DIMACS conversions...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph = from_infix(input_strs[i]);
+        std::vector<std::string> names;
+        std::string cnf = to_dimacs(graph, names);
+
+        bool ok = graph.repr() == output[i] &&
+            from_infix(to_infix(graph)).repr() == output[i] &&
+            same_models(graph, cnf, names);
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Formula: " << input_strs[i] << std::endl;
+            std::cerr << "Graph: " << graph.repr() << std::endl;
+            std::cerr << "Infix: " << to_infix(graph) << std::endl;
+            std::cerr << "CNF:\n" << cnf;
+        }
+    }
+
+    // a clause set comes back as it was written
+    std::string cnf = "c two clauses\np cnf 3 2\n1 -2 0\n2 3 0\n";
+    std::vector<std::string> names;
+    AEGraph clauses = from_dimacs(cnf);
+    if (clauses.repr() != "([[x1], x2], [[x2], [x3]])" ||
+        to_dimacs(clauses, names) != "p cnf 3 2\n1 -2 0\n2 3 0\n") {
+        total = 0;
+        std::cerr << "Wrong answer for the clause set" << std::endl;
+    }
+
+    // malformed text is rejected, not read past or looped over
+    for (std::string text : {"a $ b", "a b", "(a & b", "a & b)", "a &", ""}) {
+        try {
+            from_infix(text);
+            total = 0;
+            std::cerr << "Accepted the formula: " << text << std::endl;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    for (std::string text : {"1 -2 x 0\n", "1 - 0\n", "1 99999999999 0\n"}) {
+        try {
+            from_dimacs(text);
+            satisfiable(text);
+            total = 0;
+            std::cerr << "Accepted the clauses: " << text << std::endl;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../graph_distance.h"
+
+int main() {
+    std::vector<std::pair<std::string, std::string>> input_strs {
+        {"(a, b)", "(b, a)"},
+        {"(a)", "([a])"},
+        {"([[a]])", "(a)"},
+        {"([a, b], c)", "([a], c, d)"},
+        {"([p, [q]])", "([q, [p]])"}
+    };
+    std::vector<int> output {0, 2, 2, 2, 2};
+
+    std::cerr << "==================== Test 27 ==================\n";
+    std::cerr << "Testing tree edit distance...\n";
+    size_t len = input_strs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph a(input_strs[i].first), b(input_strs[i].second);
+        int d = tree_distance(a, b);
+        TreeDistance to_b(b);
+
+        // the distance is symmetric, the bounded one is cut at the bound
+        // and the top-down one is never smaller
+        bool ok = d == output[i] && tree_distance(b, a) == d &&
+            to_b(a) == d && tree_distance(a, b, 1) == std::min(d, 2) &&
+            to_b(a, d) == d && approximate_distance(a, b) >= d &&
+            tree_distance(a, a) == 0 && approximate_distance(a, a) == 0;
+
+        // and it is a metric
+        for (size_t k = 0; ok && k < len; k++) {
+            AEGraph c(input_strs[k].first);
+            ok = tree_distance(a, c) <= d + tree_distance(b, c);
+        }
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Graphs: " << a.repr() << " " << b.repr() << std::endl;
+            std::cerr << "Distance: " << d << std::endl;
+        }
+    }
+
+    // pairs of larger graphs: the top-down distance bounds the exact one
+    AEGraph big("([a, [b, [c, [d]]], e], [[f], g], h, [i, [j]])");
+    AEGraph other("([a, [b, [c]], e], [[f, g]], [i, [j, [k]]])");
+    int d = tree_distance(big, other);
+    if (d <= 0 || approximate_distance(big, other) < d ||
+        tree_distance(big, other, d - 1) != d) {
+        total = 0;
+        std::cerr << "Wrong answer for the larger graphs" << std::endl;
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
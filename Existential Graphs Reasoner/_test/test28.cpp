@@ -0,0 +1,116 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../proof_trace.h"
+
+int main() {
+    // a long run of rule steps: a double cut if there is one, then a
+    // deiteration, then an erasure, each time at the middle site
+    std::string text = "(";
+    for (int i = 0; i < 40; i++) {
+        std::string k = std::to_string(i);
+        text += "[[a" + k + "]], [b" + k + ", [c" + k + ", [[d" + k +
+            "]]]], a" + k + ", [e" + k + ", [a" + k + ", f" + k + "]], ";
+    }
+    AEGraph start(text + "z)");
+    start.sort();
+
+    std::vector<RuleStep> steps;
+    std::vector<AEGraph> graphs = {start};
+    while (true) {
+        const AEGraph &graph = graphs.back();
+        std::vector<std::vector<int>> sites;
+        std::string rule;
+        for (std::string name : {"DC", "DE", "E"}) {
+            sites = name == "DC" ? graph.possible_double_cuts() :
+                name == "DE" ? graph.possible_deiterations() :
+                graph.possible_erasures();
+            rule = name;
+            if (!sites.empty())
+                break;
+        }
+        if (sites.empty())
+            break;
+        steps.push_back({rule, sites[sites.size() / 2]});
+        graphs.push_back(graph.apply_step(steps.back()));
+    }
+    steps.push_back({"END", {}});
+    graphs.push_back(graphs.back());
+
+    std::vector<int> intervals {0, 1, 7, 32, 1000};
+    std::vector<std::pair<int, int>> ranges {
+        {0, 5}, {100, 130}, {17, 18}, {250, 400}, {0, 1000}};
+
+    std::cerr << "==================== Test 28 ==================\n";
+    std::cerr << "Testing binary proof traces...\n";
+    size_t len = intervals.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        std::string data = encode_trace(start, steps, intervals[i]);
+        bool ok = decode_trace(data) == steps;
+
+        // a step takes a few bytes, besides the keyframes
+        std::string bare = encode_trace(start, steps);
+        ok = ok && bare.size() - start.repr().size() < 4 * steps.size();
+
+        int begin = ranges[i].first;
+        int end = std::min<int>(ranges[i].second, steps.size());
+        int visited = 0;
+        replay_trace(data, begin, end,
+            [&](int index, const RuleStep& step, const AEGraph& graph) {
+                ok = ok && index == begin + visited && step == steps[index] &&
+                    graph.repr() == graphs[index].repr();
+                visited++;
+            });
+        ok = ok && visited == end - begin;
+
+        // a trace cut inside its first keyframe has no steps, and one with
+        // a bad record at the end has the steps before it
+        RuleStep step;
+        std::string head = data.substr(0, 10 + 100 * i);
+        TraceReader cut(head);
+        ok = ok && !cut.next(step) && cut.failed();
+        std::string tail = data + "\x07";
+        TraceReader bad(tail);
+        size_t read = 0;
+        while (bad.next(step))
+            ok = ok && read < steps.size() && step == steps[read++];
+        ok = ok && read == steps.size() && bad.failed();
+
+        // indices past the range of int, or moved below 0, are bad records
+        // as well: after the END step, a step at [2^31] and then steps at
+        // [5] and [5 - 6]
+        std::vector<std::string> records {
+            std::string("\x00\x01\x80\x80\x80\x80\x08", 7),
+            std::string("\x00\x01\x05\x00\x01\x0b", 6)};
+        for (const auto& record : records) {
+            std::string extra = data + record;
+            TraceReader range(extra);
+            read = 0;
+            while (range.next(step))
+                read++;
+            ok = ok && range.failed() &&
+                read == steps.size() + (record.size() == 6);
+        }
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+            std::cerr << "Steps: " << steps.size() << ", bytes: "
+                << bare.size() << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../knowledge_base.h"
+#include "../proof_replay.h"
+
+int main() {
+    // the same long run of rule steps as in the trace test
+    std::string text = "(";
+    for (int i = 0; i < 40; i++) {
+        std::string k = std::to_string(i);
+        text += "[[a" + k + "]], [b" + k + ", [c" + k + ", [[d" + k +
+            "]]]], a" + k + ", [e" + k + ", [a" + k + ", f" + k + "]], ";
+    }
+    AEGraph start(text + "z)");
+    start.sort();
+
+    std::vector<RuleStep> steps;
+    std::vector<AEGraph> graphs = {start};
+    while (true) {
+        const AEGraph &graph = graphs.back();
+        std::vector<std::vector<int>> sites;
+        std::string rule;
+        for (std::string name : {"DC", "DE", "E"}) {
+            sites = name == "DC" ? graph.possible_double_cuts() :
+                name == "DE" ? graph.possible_deiterations() :
+                graph.possible_erasures();
+            rule = name;
+            if (!sites.empty())
+                break;
+        }
+        if (sites.empty())
+            break;
+        steps.push_back({rule, sites[sites.size() / 2]});
+        graphs.push_back(graph.apply_step(steps.back()));
+    }
+    int n = steps.size();
+
+    std::vector<int> intervals {1, 4, 16, 64, 1000};
+    std::vector<std::vector<int>> seeks {
+        {n, 0, n / 2, n / 2 + 3},
+        {7, 3, 200, 199, 5},
+        {n - 1, 1, n - 2},
+        {100, 50, 150, 0, n},
+        {30, 10, 20}};
+    std::vector<int> broken {0, 5, n / 2, n - 1, 77};
+    std::vector<std::string> counters {
+        "(a, [a])", "([[a, [a]]])", "(a, [a, [b]], [b])",
+        "([[p, q]], [p])", "(a, [[b]], [a, b])"};
+
+    std::cerr << "==================== Test 29 ==================\n";
+    std::cerr << "Testing the proof replay engine...\n";
+    size_t len = intervals.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        ProofReplay replay(start, steps, intervals[i]);
+        bool ok = replay.validate() == -1 && replay.position() == n &&
+            replay.graph().repr() == graphs.back().repr();
+        for (int k : seeks[i]) {
+            ok = ok && replay.seek(k) && replay.position() == k &&
+                replay.graph().repr() == graphs[k].repr();
+        }
+
+        // a step that does not apply stops the replay before it
+        std::vector<RuleStep> wrong = steps;
+        wrong[broken[i]] = {"DE", {999, 0}};
+        ProofReplay stopped(start, wrong, intervals[i]);
+        ok = ok && stopped.validate() == broken[i] &&
+            stopped.position() == broken[i] &&
+            stopped.graph().repr() == graphs[broken[i]].repr();
+        ok = ok && !stopped.seek(n) && stopped.seek(broken[i] / 2) &&
+            stopped.graph().repr() == graphs[broken[i] / 2].repr();
+
+        // proofs of contradictions end with a valid "END"
+        AEGraph counter(counters[i]);
+        std::vector<RuleStep> proof = find_proof(counter);
+        ok = ok && !proof.empty() &&
+            ProofReplay(counter, proof, intervals[i]).validate() == -1;
+        ok = ok &&
+            ProofReplay(graphs[broken[i]], {{"END", {}}}).validate() == 0;
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
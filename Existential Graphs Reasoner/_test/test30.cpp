@@ -0,0 +1,72 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../knowledge_base.h"
+#include "../proof_replay.h"
+#include "../proof_enumerator.h"
+
+int main() {
+    std::vector<std::string> inputs {
+        "(a, [a, [b]], [b])",
+        "([[a]], [a], [[b]], [b, c])",
+        "(a, [[b]], [a, b])",
+        "(a, b, [a, b, [c]], [c])",
+        "(a, [b])"};
+    std::vector<int> counts {3, 28, 4, 28, 0};
+    std::vector<size_t> shortest {3, 4, 4, 5, 0};
+
+    std::cerr << "==================== Test 30 ==================\n";
+    std::cerr << "Testing the enumeration of proofs...\n";
+    size_t len = inputs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph(inputs[i]);
+        ProofEnumerator depth(graph), breadth(graph, true);
+        std::vector<std::vector<RuleStep>> first, second;
+        std::vector<RuleStep> proof;
+        while (depth.next(proof)) {
+            first.push_back(proof);
+        }
+        while (breadth.next(proof)) {
+            second.push_back(proof);
+        }
+
+        // the same distinct proofs, the first one being find_proof()'s
+        std::set<std::vector<RuleStep>> distinct(first.begin(), first.end());
+        bool ok = static_cast<int>(first.size()) == counts[i] &&
+            depth.count() == counts[i] && distinct.size() == first.size() &&
+            std::set<std::vector<RuleStep>>(second.begin(), second.end()) ==
+            distinct && !depth.next(proof);
+        ok = ok && (first.empty() ? find_proof(graph).empty() :
+            first[0] == find_proof(graph));
+
+        for (size_t k = 0; k < second.size(); k++) {
+            ok = ok && ProofReplay(graph, second[k]).validate() == -1 &&
+                (k == 0 || second[k - 1].size() <= second[k].size());
+        }
+        ok = ok && (second.empty() || second[0].size() == shortest[i]);
+
+        auto some = shortest_proofs(graph, 2);
+        ok = ok && some.size() == std::min<size_t>(2, second.size()) &&
+            std::equal(some.begin(), some.end(), second.begin());
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../formula_io.h"
+
+int main() {
+    // x1 -> x2 -> ... -> x25, too many atoms to try every assignment
+    std::string chain = "x1 -> x2";
+    std::string all = "x1";
+    for (int i = 2; i < 25; i++) {
+        chain += " & (x" + std::to_string(i) + " -> x" +
+            std::to_string(i + 1) + ")";
+        all += " & x" + std::to_string(i);
+    }
+    all += " & x25";
+
+    std::vector<std::pair<AEGraph, AEGraph>> inputs {
+        {AEGraph("([[a]], b, b)"), AEGraph("(b, a)")},
+        {AEGraph("(a, [b])"), AEGraph("(a, [b, a])")},
+        {AEGraph("([a, [b]])"), AEGraph("([b, [a]])")},
+        {from_infix("x1 & (x1 | c) & " + chain), from_infix("x1 & " + chain)},
+        {from_infix(chain + " & !(" + all + ")"), from_infix(chain)}};
+    std::vector<bool> outputs {true, true, false, true, false};
+    // every contradiction is the empty cut
+    AEGraph empty("([])");
+
+    std::cerr << "==================== Test 31 ==================\n";
+    std::cerr << "Testing equivalence of graphs...\n";
+    size_t len = inputs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        const AEGraph &a = inputs[i].first, &b = inputs[i].second;
+        bool ok = a.equivalent(b) == outputs[i] &&
+            b.equivalent(a) == outputs[i] && a.equivalent(a) &&
+            (a.repr() != b.repr() || outputs[i]);
+
+        AEGraph contradiction = AEGraph::counterset(a, a);
+        ok = ok && contradiction.equivalent(empty) &&
+            AEGraph::enclose(contradiction).equivalent(AEGraph("()"));
+
+        std::vector<std::string> names;
+        ok = ok && satisfiable(to_dimacs(a, names)) &&
+            !satisfiable(to_dimacs(contradiction, names));
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
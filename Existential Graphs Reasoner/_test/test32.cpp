@@ -0,0 +1,60 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include "../aegraph.h"
+#include "../proof_replay.h"
+#include "../bidirectional_search.h"
+
+int main() {
+    std::vector<std::pair<std::string, std::string>> inputs {
+        {"(a, [a, b])", "([b])"},
+        {"([[a1]], [[a2]], [[a3]], [[a4]], [[a5]], [[a6]])",
+         "(a1, a2, a3, a4, a5, a6)"},
+        {"(p, [p, [q]], [q, [r]], [r, [s]])", "(s)"},
+        {"(a, [b, [a, c]], d, [[e, f]])", "(a, [b, [c]], e)"},
+        {"(a, [a, [b]], c)", "(b, d)"}};
+    std::vector<bool> outputs {true, true, true, true, false};
+    // whether meeting in the middle reaches fewer graphs
+    std::vector<bool> fewer {false, true, false, true, false};
+
+    std::cerr << "==================== Test 32 ==================\n";
+    std::cerr << "Testing bidirectional proof search...\n";
+    size_t len = inputs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph premise(inputs[i].first), conclusion(inputs[i].second);
+        ForwardProof both = forward_proof(premise, conclusion);
+        ForwardProof one = forward_proof(premise, conclusion, false);
+        bool ok = both.found == outputs[i] && one.found == outputs[i] &&
+            one.backward_graphs == 0;
+
+        // the steps are forward rules that end at the conclusion
+        conclusion.sort();
+        for (const ForwardProof* proof : {&both, &one}) {
+            ProofReplay replay(premise, proof->steps);
+            ok = ok && replay.validate() == -1 &&
+                (!proof->found || replay.graph() == conclusion);
+        }
+        if (fewer[i]) {
+            ok = ok && both.forward_graphs + both.backward_graphs <
+                one.forward_graphs;
+        }
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
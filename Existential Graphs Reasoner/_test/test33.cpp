@@ -0,0 +1,84 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+#include "../knowledge_base.h"
+
+// the recursive search of the full proof test, as the reference for
+// find_proof(): double cuts, deiterations and erasures, in that order
+std::vector<RuleStep> reduce(AEGraph graph);
+
+std::vector<RuleStep> bactracking_step(AEGraph graph, std::string op) {
+    std::vector<std::vector<int>> steps;
+    if (op == "DC")
+        steps = graph.possible_double_cuts();
+    else if (op == "DE")
+        steps = graph.possible_deiterations();
+    else
+        steps = graph.possible_erasures();
+
+    for (auto &step : steps) {
+        auto r = reduce(graph.apply_step({op, step}));
+        if (!r.empty()) {
+            r.insert(r.begin(), make_pair(op, step));
+            return r;
+        }
+    }
+    return {};
+}
+
+std::vector<RuleStep> reduce(AEGraph graph) {
+    if (is_contradiction(graph))
+        return {{"END", {}}};
+
+    for (auto op : {"DC", "DE", "E"}) {
+        auto r = bactracking_step(graph, op);
+        if (!r.empty())
+            return r;
+    }
+    return {};
+}
+
+int main() {
+    std::vector<std::pair<std::string, std::string>> inputs {
+        {"(A)", "([[A]])"},
+        {"(p, [p, [q]])", "(q)"},
+        {"(r, [p, [q]])", "(q)"},
+        {"(a, [a, [b]], [b, [c]])", "(c, a)"},
+        {"(P, Q, R, [[A], [B]])", "(P, A, B)"}};
+
+    std::cerr << "==================== Test 33 ==================\n";
+    std::cerr << "Testing the library proof search...\n";
+    size_t len = inputs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        AEGraph graph = AEGraph::counterset(AEGraph(inputs[i].first),
+            AEGraph(inputs[i].second));
+        graph.sort();
+        auto expected = reduce(graph);
+        auto proof = find_proof(graph);
+
+        // the same first proof, and its steps end in a contradiction
+        bool ok = proof == expected;
+        for (size_t k = 0; ok && k + 1 < proof.size(); k++) {
+            graph = graph.apply_step(proof[k]);
+        }
+        ok = ok && (proof.empty() || is_contradiction(graph));
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
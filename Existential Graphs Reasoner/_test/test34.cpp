@@ -0,0 +1,57 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include "../aegraph.h"
+#include "../formula_io.h"
+
+bool refuted(const AEGraph& graph) {
+    std::vector<std::string> names;
+    return !satisfiable(to_dimacs(graph, names));
+}
+
+int main() {
+    // x1, ..., x25: a cut around all of them is false on a single one of
+    // the 2^25 assignments, which random ones almost never hit
+    std::string all = "x1";
+    for (int i = 2; i <= 25; i++) {
+        all += ", x" + std::to_string(i);
+    }
+    std::string most = all.substr(0, all.rfind(','));
+
+    std::vector<std::pair<AEGraph, AEGraph>> inputs {
+        {AEGraph("([" + all + "])"), AEGraph("()")},
+        {AEGraph("([" + all + ", x1, [[x2]]])"), AEGraph("([" + all + "])")},
+        {AEGraph("([" + all + ", [[x1], [x2]]])"), AEGraph("([" + all + "])")},
+        {AEGraph("([[" + all + "]])"), AEGraph("(" + most + ")")},
+        {AEGraph("([" + all + ", [x26]])"), AEGraph("([" + all + "])")}};
+    std::vector<bool> outputs {false, true, true, false, false};
+
+    std::cerr << "==================== Test 34 ==================\n";
+    std::cerr << "Testing equivalence of single cuts...\n";
+    size_t len = inputs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        const AEGraph &a = inputs[i].first, &b = inputs[i].second;
+        // the answer of the solver on both implications
+        bool reference = refuted(AEGraph::counterset(a, b)) &&
+            refuted(AEGraph::counterset(b, a));
+        bool ok = reference == outputs[i] &&
+            a.equivalent(b) == outputs[i] && b.equivalent(a) == outputs[i];
+
+        if (!ok) {
+            total -= 2;
+            std::cerr << "Wrong answer for input number " << i+1 << std::endl;
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -10,12 +10,12 @@ std::vector<std::pair<std::string, std::vector<int>>> reduce(AEGraph graph);
 
 std::vector<std::pair<std::string, std::vector<int>>>
 bactracking_step(AEGraph graph, std::string op) {
+    // the possible_* functions already list the steps in sorted order, and
+    // the rules keep the graph sorted
     if (op == "DE") {
         auto steps = graph.possible_deiterations();
-        sort(steps.begin(), steps.end());
         for (auto &step : steps) {
             auto g = graph.deiterate(step);
-            g.sort();
             auto r = reduce(g);
             if (!r.empty()) {
                 r.insert(r.begin(), make_pair("DE", step));
@@ -24,10 +24,8 @@ bactracking_step(AEGraph graph, std::string op) {
         }
     } else if (op == "DC") {
         auto steps = graph.possible_double_cuts();
-        sort(steps.begin(), steps.end());
         for (auto &step : steps) {
             auto g = graph.double_cut(step);
-            g.sort();
             auto r = reduce(g);
             if (!r.empty()) {
                 r.insert(r.begin(), make_pair("DC", step));
@@ -36,10 +34,8 @@ bactracking_step(AEGraph graph, std::string op) {
         }
     } else if (op == "E") {
         auto steps = graph.possible_erasures();
-        sort(steps.begin(), steps.end());
         for (auto &step : steps) {
             auto g = graph.erase(step);
-            g.sort();
             auto r = reduce(g);
             if (!r.empty()) {
                 r.insert(r.begin(), make_pair("E", step));
@@ -77,10 +73,7 @@ std::vector<std::pair<std::string, std::vector<int>>> reduce(AEGraph graph) {
 }
 
 AEGraph make_counterset(AEGraph premise, AEGraph conclusion) {
-    std::string prem = premise.repr().substr(1, premise.repr().size() - 2);
-    std::string conc = conclusion.repr().substr(1,
-        conclusion.repr().size() - 2);
-    return AEGraph("(" + prem + ", [" + conc + "])");
+    return AEGraph::counterset(premise, conclusion);
 }
 
 std::vector<std::pair<std::string, std::vector<int>>> steps_to(AEGraph premise,
@@ -0,0 +1,61 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <string>
+#include "../aegraph.h"
+
+int main() {
+    std::vector<std::string> input_strs {
+        "([[A]], [[P], B])",
+        "(S, [[P]], [A, [B], [[C, D]]])",
+        "([[[Z, [Y]]]], [X], [[A], [[B, [[C]]]]])",
+        "(A, B, C, D, [A, [B, C], [D, [A, [B]]]])",
+        "(p, q, [p, [q], [[r, [s]]]], [[q]])"
+    };
+
+    std::vector<AEGraph> inputs;
+    for (auto s : input_strs) {
+        inputs.emplace_back(AEGraph(s));
+    }
+
+    std::cerr << "==================== Test 8 ===================\n";
+    std::cerr << "Testing canonical order after rule application...\n";
+    size_t len = inputs.size();
+    unsigned int total = len * 2;
+    for (size_t i = 0; i < len; i++) {
+        std::vector<AEGraph> results;
+        for (auto &step : inputs[i].possible_double_cuts())
+            results.push_back(inputs[i].double_cut(step));
+        for (auto &step : inputs[i].possible_erasures())
+            results.push_back(inputs[i].erase(step));
+        for (auto &step : inputs[i].possible_deiterations())
+            results.push_back(inputs[i].deiterate(step));
+
+        for (auto &res : results) {
+            // the rules must leave the graph canonical, so sorting it
+            // again cannot change its representation
+            auto sorted = res;
+            sorted.sort();
+            if (res.repr() != sorted.repr()) {
+                total -= 2;
+                std::cerr << "Wrong answer for input number " << i+1
+                    << std::endl;
+                std::cerr << "Expected: " << sorted.repr() << std::endl;
+                std::cerr << "Got: " << res.repr() << std::endl;
+                break;
+            }
+        }
+    }
+
+    if (total == len * 2) {
+        std::cerr << "passed: " << total << "/" << len * 2 << std::endl;
+        std::cout << total << std::endl;
+    } else {
+        std::cerr << "failed: " << total << "/" << len * 2 << std::endl;
+        std::cout << 0 << std::endl;
+    }
+    return 0;
+}
@@ -6,9 +6,16 @@
 #include <algorithm>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <functional>
 #include <utility>
 #include <cassert>
+#include <cstdint>
+#include <atomic>
+#include <numeric>
+#include <memory>
 #include "./aegraph.h"
+#include "./aegraph_engine.h"
 
 std::string strip(std::string s) {
     // deletes whitespace from the beginning and end of the string
@@ -17,43 +24,55 @@ std::string strip(std::string s) {
     return s;
 }
 
-std::pair<std::string, std::string> split_first(std::string s,
-    char delimiter = ',') {
-    // returns a pair that contains: <first_cut, rest_of_graph>
-
-    int numOpen = 0;
+uint64_t mix64(uint64_t x) {
+    // splitmix64 finalizer; makes the nesting of the cuts matter, since the
+    // plain sum of the children's hashes is order independent
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
 
-    int len = s.size();
-    for (int i = 0; i < len; i++) {
-        char c = s[i];
-        if (c == delimiter && numOpen == 0)
-            return std::make_pair(
-                    strip(s.substr(0, i)), strip(s.substr(i+1, len)));
-        if (c == '[')
-            numOpen += 1;
-        if (c == ']')
-            numOpen -= 1;
+uint64_t atom_hash(const std::string& atom) {
+    // FNV-1a, so the hashes do not depend on the standard library
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : atom) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
     }
-
-    return {strip(s), std::string()};
+    return mix64(h);
 }
 
 
-std::vector<std::string> split_level(std::string s, char delimiter = ',') {
-    // splits 's' into separate entities (atoms, subgraphs)
-
-    std::vector<std::string> result;
-    auto snd = s;
-    while (true) {
-        auto p = split_first(snd, delimiter);
-        auto fst = p.first;
-        snd = p.second;
-
-        result.push_back(fst);
+uint64_t AEGraph::new_id() {
+    // ids are never reused, so copies of a graph (and the graphs obtained
+    // from it by applying rules) agree on the ids of the nodes they share
+    static std::atomic<uint64_t> next_id(1);
+    return next_id++;
+}
 
-        if (snd.empty())
-            return result;
+std::vector<uint64_t> AEGraph::renumber() {
+    // gives fresh ids to every node and atom, so a copy can be told apart
+    // from the graph it was made from; returns the new ids
+    std::vector<uint64_t> ids;
+    std::vector<AEGraph*> stack = {this};
+    while (!stack.empty()) {
+        AEGraph *node = stack.back();
+        stack.pop_back();
+
+        node->id = new_id();
+        ids.push_back(node->id);
+        for (auto& atom_id : node->atom_ids) {
+            atom_id = new_id();
+            ids.push_back(atom_id);
+        }
+        for (auto& sg : node->subgraphs) {
+            stack.push_back(&sg);
+        }
     }
+    return ids;
 }
 
 
@@ -72,16 +91,24 @@ int AEGraph::size() const {
 }
 
 
+// the algorithms shared with the other storages of aegraph_engine.h, run
+// on the nodes of AEGraph
+using Engine = GraphAlgorithms<AEGraphStorage>;
+
 bool AEGraph::operator<(const AEGraph& other) const {
-    return this->repr() < other.repr();
+    // the order of the representations, read through the labels the
+    // subgraphs keep instead of being written out
+    return Engine::compare(AEGraphStorage(), this, &other) < 0;
 }
 
 bool AEGraph::operator==(const AEGraph& other) const {
-    return this->repr() == other.repr();
+    // graphs with different hashes differ; equal hashes are confirmed
+    return hash_value == other.hash_value &&
+        Engine::compare(AEGraphStorage(), this, &other) == 0;
 }
 
 bool AEGraph::operator!=(const AEGraph& other) const {
-    return this->repr() != other.repr();
+    return !(*this == other);
 }
 
 AEGraph AEGraph::operator[](const int index) const {
@@ -102,7 +129,53 @@ std::ostream& operator<<(std::ostream &out, const AEGraph &g) {
     return out;
 }
 
-AEGraph::AEGraph(std::string representation) {
+AEGraph::AEGraph() : is_SA(false), id(0), hash_value(0), sums() {}
+
+void sort_area(AEGraph &node) {
+    // sorts the elements of a single area, whose own subgraphs are already
+    // sorted, and recomputes its cached sums
+
+    // atoms that were added by hand get fresh ids
+    while (node.atom_ids.size() < node.atoms.size()) {
+        node.atom_ids.push_back(AEGraph::new_id());
+    }
+    node.atom_ids.resize(node.atoms.size());
+
+    // sort the atoms and their ids together
+    std::vector<int> order(node.atoms.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return node.atoms[a] < node.atoms[b];
+    });
+    std::vector<std::string> sorted_atoms;
+    std::vector<uint64_t> sorted_ids;
+    for (int i : order) {
+        sorted_atoms.push_back(std::move(node.atoms[i]));
+        sorted_ids.push_back(node.atom_ids[i]);
+    }
+    node.atoms = std::move(sorted_atoms);
+    node.atom_ids = std::move(sorted_ids);
+
+    // the subgraphs are compared where they first differ, so no label is
+    // built for the sort
+    if (node.num_subgraphs() > 1) {
+        std::vector<int> order(node.num_subgraphs());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return node.subgraphs[a] < node.subgraphs[b];
+        });
+        std::vector<AEGraph> sorted_subgraphs;
+        sorted_subgraphs.reserve(order.size());
+        for (int i : order) {
+            sorted_subgraphs.push_back(std::move(node.subgraphs[i]));
+        }
+        node.subgraphs = std::move(sorted_subgraphs);
+    }
+
+    node.refresh();
+}
+
+AEGraph::AEGraph(std::string representation) : AEGraph() {
     // constructor that creates an AEGraph structure from a
     // serialized representation
     char left_sep = representation[0];
@@ -120,172 +193,327 @@ AEGraph::AEGraph(std::string representation) {
     } else {
         is_SA = false;
     }
-
-    // eliminate the first pair of [] or ()
-    representation = representation.substr(1, representation.size() - 2);
-
-    // split the graph into separate elements
-    auto v = split_level(representation);
-    // add them to the corresponding vector
-    for (auto s : v) {
-        if (s[0] != '[') {
-            atoms.push_back(s);
+    id = new_id();
+
+    // a single pass over the text; the cuts that are still open are kept
+    // on a stack, so the nesting depth does not use up the call stack
+    std::vector<AEGraph> open;
+    std::string atom;
+    // whether the current element is a cut that was already closed
+    bool closed = false;
+
+    auto finish_element = [&](AEGraph &area) {
+        // adds the current element to <area> if it is an atom (an empty
+        // area has no elements)
+        std::string text = strip(atom);
+        assert(!closed || text.empty());
+        if (!closed && !text.empty()) {
+            area.atoms.push_back(text);
+            area.atom_ids.push_back(new_id());
+        }
+        atom.clear();
+        closed = false;
+    };
+
+    int len = representation.size();
+    for (int i = 1; i < len - 1; i++) {
+        char c = representation[i];
+        if (c == '[') {
+            assert(!closed && strip(atom).empty());
+            open.push_back(AEGraph());
+            open.back().id = new_id();
+        } else if (c == ',') {
+            finish_element(open.empty() ? *this : open.back());
+        } else if (c == ']') {
+            assert(!open.empty());
+            finish_element(open.back());
+            // the subgraphs of the cut are complete, so it can be sorted
+            sort_area(open.back());
+            AEGraph cut = std::move(open.back());
+            open.pop_back();
+            (open.empty() ? *this : open.back()).subgraphs.push_back(
+                std::move(cut));
+            closed = true;
         } else {
-            subgraphs.push_back(AEGraph(s));
+            atom += c;
         }
     }
+    assert(open.empty());
+    finish_element(*this);
 
     // also internally sort the new graph
-    this->sort();
+    sort_area(*this);
+}
+
+AEGraph::AEGraph(const AEGraph& other) : AEGraph() {
+    // copies the tree one node at a time, with an explicit stack
+    std::vector<std::pair<AEGraph*, const AEGraph*>> stack = {{this, &other}};
+    while (!stack.empty()) {
+        AEGraph &to = *stack.back().first;
+        const AEGraph &from = *stack.back().second;
+        stack.pop_back();
+
+        to.atoms = from.atoms;
+        to.is_SA = from.is_SA;
+        to.id = from.id;
+        to.atom_ids = from.atom_ids;
+        to.hash_value = from.hash_value;
+        to.sums = from.sums;
+        to.label_cache = from.label_cache;
+
+        to.subgraphs.reserve(from.subgraphs.size());
+        for (size_t i = 0; i < from.subgraphs.size(); i++) {
+            to.subgraphs.push_back(AEGraph());
+        }
+        for (size_t i = 0; i < from.subgraphs.size(); i++) {
+            stack.push_back({&to.subgraphs[i], &from.subgraphs[i]});
+        }
+    }
+}
+
+AEGraph& AEGraph::operator=(const AEGraph& other) {
+    AEGraph copy(other);
+    return *this = std::move(copy);
+}
+
+AEGraph& AEGraph::operator=(AEGraph&& other) noexcept {
+    // <other> may be a part of this graph, so it is taken out before the
+    // old contents are released (by the destructor of <taken>)
+    AEGraph taken(std::move(other));
+    std::swap(atoms, taken.atoms);
+    std::swap(subgraphs, taken.subgraphs);
+    std::swap(is_SA, taken.is_SA);
+    std::swap(id, taken.id);
+    std::swap(atom_ids, taken.atom_ids);
+    std::swap(hash_value, taken.hash_value);
+    std::swap(sums, taken.sums);
+    std::swap(label_cache, taken.label_cache);
+    return *this;
+}
+
+AEGraph::~AEGraph() {
+    // releases the subtree level by level: every cut is emptied before it
+    // is destroyed, so no destructor call nests into another one
+    std::vector<AEGraph> pending = std::move(subgraphs);
+    while (!pending.empty()) {
+        std::vector<AEGraph> children = std::move(pending.back().subgraphs);
+        pending.pop_back();
+        for (auto& sg : children) {
+            pending.push_back(std::move(sg));
+        }
+    }
 }
 
 std::string AEGraph::repr() const {
     // returns the serialized representation of the AEGraph
+    return Engine::repr(AEGraphStorage(), this);
+}
 
-    std::string left, right;
-    if (is_SA) {
-        left = '(';
-        right = ')';
-    } else {
-        left = '[';
-        right = ']';
+bool AEGraph::has_label() const {
+    return label_cache != nullptr;
+}
+
+const std::string& AEGraph::label() const {
+    // a changed node gets its label from the labels its subgraphs kept,
+    // so only the nodes that changed are serialized again
+    if (!label_cache) {
+        label_cache = std::make_shared<const std::string>(
+            Engine::repr(AEGraphStorage(), this, true));
     }
+    return *label_cache;
+}
+
 
-    std::string result;
-    for (auto subgraph : subgraphs) {
-        result += subgraph.repr() + ", ";
+void AEGraph::sort() {
+    // an area is sorted once all of its subgraphs are (post-order, with an
+    // explicit stack of (node, whether its subgraphs were pushed))
+    std::vector<std::pair<AEGraph*, bool>> stack = {{this, false}};
+    while (!stack.empty()) {
+        AEGraph *node = stack.back().first;
+        if (stack.back().second) {
+            stack.pop_back();
+            sort_area(*node);
+            continue;
+        }
+
+        stack.back().second = true;
+        for (auto& sg : node->subgraphs) {
+            stack.push_back({&sg, false});
+        }
     }
+}
 
-    int len = atoms.size();
-    if (len != 0) {
-        for (int i = 0; i < len - 1; i++) {
-            result += atoms[i] + ", ";
+void AEGraph::compact() {
+    // reallocates the buffers of every node in depth-first order, with
+    // exact capacities; the heap then holds a node's children right after
+    // it, like in a freshly parsed graph, instead of wherever the rules
+    // that resized them left them
+    std::vector<AEGraph*> stack = {this};
+    while (!stack.empty()) {
+        AEGraph *node = stack.back();
+        stack.pop_back();
+
+        std::vector<AEGraph> children;
+        children.reserve(node->subgraphs.size());
+        for (auto& sg : node->subgraphs) {
+            children.push_back(std::move(sg));
+        }
+        node->subgraphs = std::move(children);
+        node->atoms = std::vector<std::string>(node->atoms.begin(),
+            node->atoms.end());
+        node->atom_ids = std::vector<uint64_t>(node->atom_ids.begin(),
+            node->atom_ids.end());
+
+        // the first child is laid out first
+        for (int i = node->num_subgraphs() - 1; i >= 0; i--) {
+            stack.push_back(&node->subgraphs[i]);
         }
-        result += atoms[len - 1];
-    } else {
-        if (subgraphs.size() != 0)
-            return left + result.substr(0, result.size() - 2) + right;
     }
+}
 
-    return left + result + right;
+uint64_t AEGraph::hash() const {
+    return hash_value;
 }
 
+AEGraph::Contribution AEGraph::contribution() const {
+    // what this subtree adds to the cached sums of its parent
+    Contribution c;
+    c.hash = hash_value;
+    c.double_cuts = sums.double_cuts +
+        (num_subgraphs() == 1 && num_atoms() == 0);
+    c.erasures[0] = count_erasures(0);
+    c.erasures[1] = count_erasures(1);
+    c.nodes = sums.nodes + 1;
+    c.atoms = sums.atoms;
+    c.height = sums.height + 1;
+    return c;
+}
 
-void AEGraph::sort() {
-    std::sort(atoms.begin(), atoms.end());
+AEGraph::Contribution AEGraph::atom_contribution(const std::string& atom) {
+    Contribution c = Contribution();
+    c.hash = atom_hash(atom);
+    c.nodes = 1;
+    c.atoms = 1;
+    return c;
+}
 
-    for (auto& sg : subgraphs) {
-        sg.sort();
+void AEGraph::refresh() {
+    // recomputes the cached sums of this node from the (cached) sums of
+    // its children; none of them depends on the children's order
+    sums = Contribution();
+    for (const auto& atom : atoms) {
+        update_child(Contribution(), atom_contribution(atom));
     }
-
-    std::sort(subgraphs.begin(), subgraphs.end());
+    for (const auto& sg : subgraphs) {
+        update_child(Contribution(), sg.contribution());
+    }
+    update_child(Contribution(), Contribution());
 }
 
-bool AEGraph::contains(const std::string other) const {
-    // checks if an atom is in a graph
-    if (find(atoms.begin(), atoms.end(), other) != atoms.end())
-        return true;
+void AEGraph::update_child(const Contribution& removed,
+    const Contribution& added) {
+    // O(1) update after a child contributing <removed> was replaced by
+    // one contributing <added>, once the child vectors reflect the change
+    label_cache.reset();
+    sums.hash += added.hash - removed.hash;
+    sums.double_cuts += added.double_cuts - removed.double_cuts;
+    sums.erasures[0] += added.erasures[0] - removed.erasures[0];
+    sums.erasures[1] += added.erasures[1] - removed.erasures[1];
+    sums.nodes += added.nodes - removed.nodes;
+    sums.atoms += added.atoms - removed.atoms;
+
+    // the height is a maximum; it is only rescanned when the child that
+    // reached it got lower (the children must already be up to date)
+    if (added.height >= sums.height) {
+        sums.height = added.height;
+    } else if (removed.height == sums.height) {
+        sums.height = 0;
+        for (const auto& sg : subgraphs) {
+            sums.height = std::max(sums.height, sg.sums.height + 1);
+        }
+    }
 
-    for (const auto& sg : subgraphs)
-        if (sg.contains(other))
-            return true;
+    hash_value = mix64(sums.hash ^ (is_SA ? 0x5a5a5a5a5a5a5a5aULL
+                                          : 0xa5a5a5a5a5a5a5a5ULL));
+}
 
-    return false;
+void AEGraph::insert_atom(std::string atom, uint64_t atom_id) {
+    // keeps the atoms sorted without re-sorting the whole vector
+    AEGraphStorage storage;
+    Engine::insert_atom(storage, this, {std::move(atom), atom_id});
 }
 
-bool AEGraph::contains(const AEGraph& other) const {
-    // checks if a subgraph is in a graph
-    if (find(subgraphs.begin(), subgraphs.end(), other) != subgraphs.end())
-        return true;
+void AEGraph::remove_atom(int index) {
+    Contribution removed = atom_contribution(atoms[index]);
+    atoms.erase(atoms.begin() + index);
+    atom_ids.erase(atom_ids.begin() + index);
+    update_child(removed, Contribution());
+}
 
-    for (const auto& sg : subgraphs)
-        if (sg.contains(other))
-            return true;
+void AEGraph::remove_subgraph(int index) {
+    take_subgraph(index);
+}
 
-    return false;
+AEGraph AEGraph::take_subgraph(int index) {
+    // removes subgraphs[index] and hands it over without copying it
+    Contribution removed = subgraphs[index].contribution();
+    AEGraph subgraph = std::move(subgraphs[index]);
+    subgraphs.erase(subgraphs.begin() + index);
+    update_child(removed, Contribution());
+    return subgraph;
 }
 
-std::vector<std::vector<int>> AEGraph::get_paths_to(const std::string other)
-    const {
-    // returns all paths in the tree that lead to an atom like <other>
-    std::vector<std::vector<int>> paths;
+void AEGraph::insert_subgraph(AEGraph subgraph) {
+    // places a canonical subgraph among its (sorted) siblings by binary
+    // search, comparing the labels they keep
+    AEGraphStorage storage;
+    Engine::insert_subgraph(storage, this, std::move(subgraph));
+}
 
-    int len_atoms = num_atoms();
-    int len_subgraphs = num_subgraphs();
+int AEGraph::reposition(int index) {
+    // restores the canonical order after subgraphs[index] changed while
+    // every other sibling stayed sorted; returns the child's new index.
+    // Only the changed child is labelled again; the siblings compare by
+    // the labels they kept.
+    label_cache.reset();
+    AEGraphStorage storage;
+    return Engine::reposition(storage, this, index);
+}
 
-    for (int i = 0; i < len_atoms; i++) {
-        if (atoms[i] == other && size() > 1) {
-            paths.push_back({i + len_subgraphs});
-        }
-    }
+bool AEGraph::contains(const std::string other) const {
+    // checks if an atom is in a graph
+    return Engine::contains(AEGraphStorage(), this, other);
+}
 
-    for (int i = 0; i < len_subgraphs; i++) {
-        if (subgraphs[i].contains(other)) {
-            auto r = subgraphs[i].get_paths_to(other);
-            for (auto& v : r)
-                v.insert(v.begin(), i);
-            copy(r.begin(), r.end(), back_inserter(paths));
-        }
-    }
+bool AEGraph::contains(const AEGraph& other) const {
+    // checks if a subgraph is in a graph; only the subgraphs with the same
+    // hash are compared
+    return Engine::contains(AEGraphStorage(), this, AEGraphStorage(), &other);
+}
 
-    return paths;
+std::vector<std::vector<int>> AEGraph::get_paths_to(const std::string other)
+    const {
+    // returns all paths in the tree that lead to an atom like <other>; the
+    // atoms of an area are listed before the paths inside its subgraphs
+    return Engine::get_paths_to(AEGraphStorage(), this, other);
 }
 
 std::vector<std::vector<int>> AEGraph::get_paths_to(const AEGraph& other)
     const {
     // returns all paths in the tree that lead to a subgraph like <other>
-    std::vector<std::vector<int>> paths;
-    int len_subgraphs = num_subgraphs();
-
-    for (int i = 0; i < len_subgraphs; i++) {
-        if (subgraphs[i] == other && size() > 1) {
-            paths.push_back({i});
-        } else {
-            auto r = subgraphs[i].get_paths_to(other);
-            for (auto& v : r)
-                v.insert(v.begin(), i);
-            copy(r.begin(), r.end(), back_inserter(paths));
-        }
-    }
-
-    return paths;
+    return Engine::get_paths_to(AEGraphStorage(), this, AEGraphStorage(),
+        &other);
 }
 
 // nu mergem pe atomi
 std::vector<std::vector<int>> AEGraph::possible_double_cuts() const {
     // 10p
-    std::vector<std::vector<int>> road;
-    int len_subgraphs = num_subgraphs();
-    for (int i = 0; i < len_subgraphs; i++) {
-            if (subgraphs[i].num_subgraphs() == 1 &&
-            subgraphs[i].num_atoms() == 0) {
-                road.push_back({i});
-            }
-            auto r = subgraphs[i].possible_double_cuts();
-            for (auto& v : r) {
-                v.insert(v.begin(), i);
-            }
-            copy(r.begin(), r.end(), back_inserter(road));
-    }
-    return road;
+    return Engine::possible_double_cuts(AEGraphStorage(), this);
 }
 
 void AEGraph::double_cut_helper(std::vector<int> where, AEGraph &node) const {
-    if (where.capacity() != 1) {
-        unsigned int index;
-        index = where[0];
-        where.erase(where.begin());
-        node.double_cut_helper(where, node.subgraphs[index]);
-    } else if (where.capacity() == 1) {
-        AEGraph aux = node.subgraphs[where[0]].subgraphs[0];
-        for (int i = 0; i < aux.num_subgraphs(); ++i) {
-            node.subgraphs.push_back(aux.subgraphs[i]);
-        }
-        for (int i = 0; i < aux.num_atoms(); ++i) {
-            node.atoms.push_back(aux.atoms[i]);
-        }
-        node.subgraphs.erase(node.subgraphs.begin() + where[0]);
-    }
+    AEGraphStorage storage;
+    Engine::double_cut(storage, &node, where);
 }
 
 AEGraph AEGraph::double_cut(std::vector<int> where) const {
@@ -298,46 +526,12 @@ AEGraph AEGraph::double_cut(std::vector<int> where) const {
 // mergem pe atomi
 std::vector<std::vector<int>> AEGraph::possible_erasures(int level) const {
     // 10p
-    std::vector<std::vector<int>> road;
-    int len_subgraphs = num_subgraphs();
-    int len_atoms = num_atoms();
-    for (int i = 0; i < (len_subgraphs + len_atoms); i++) {
-        if (level % 2 != 0) {
-            road.push_back({i});
-            if (level != -1 && (!num_subgraphs() &&
-            num_atoms() == 1) && road.size()) {
-                road.pop_back();
-            }
-            if (level != -1 && (num_subgraphs() == 1 &&
-            !num_atoms()) && road.size()) {
-                road.pop_back();                }
-            }
-         	if (i < num_subgraphs()) {
-            	auto r = subgraphs[i].possible_erasures(level + 1);
-                for (auto& v : r) {
-                    v.insert(v.begin(), i);
-                }
-                copy(r.begin(), r.end(), back_inserter(road));
-            }
-    }
-    return road;
+    return Engine::possible_erasures(AEGraphStorage(), this, level);
 }
 
 void AEGraph::erase_helper(std::vector<int> where, AEGraph &node) const {
-    if (where.capacity() != 1) {
-        unsigned int index;
-        index = where[0];
-        where.erase(where.begin());
-        node.erase_helper(where, node.subgraphs[index]);
-    } else if (where.capacity() == 1) {
-        if (node.num_subgraphs() - where[0] <= 0) {
-            node.atoms.erase(node.atoms.begin() -
-            node.num_subgraphs() + where[0]);
-        } else if (node.num_subgraphs() - where[0] > 0) {
-            node.subgraphs.erase(node.subgraphs.begin()
-            + where[0]);
-        }
-    }
+    AEGraphStorage storage;
+    Engine::erase(storage, &node, where);
 }
 
 AEGraph AEGraph::erase(std::vector<int> where) const {
@@ -350,50 +544,636 @@ AEGraph AEGraph::erase(std::vector<int> where) const {
 
 std::vector<std::vector<int>> AEGraph::possible_deiterations() const {
     // 20p
-    std::vector<std::vector<int>> road;
-    for (int i = 0; i < num_subgraphs(); ++i) {
-        for (int j = 0; j < num_subgraphs(); ++j) {
-            if (i != j) {
-                auto r = subgraphs[j].get_paths_to(subgraphs[i]);
-                for (auto& v : r) {
-                    v.insert(v.begin(), j);
+    return Engine::possible_deiterations(AEGraphStorage(), this);
+}
+
+void AEGraph::deiterate_helper(std::vector<int> where, AEGraph &node) const {
+    AEGraphStorage storage;
+    Engine::deiterate(storage, &node, where);
+}
+
+AEGraph AEGraph::deiterate(std::vector<int> where) const {
+    // 10p
+    AEGraph auxiliar = *this;
+    deiterate_helper(where, auxiliar);
+    return auxiliar;
+}
+
+
+uint64_t AEGraph::node_id(const std::vector<int>& where) const {
+    // returns the id of the atom or subgraph at <where>
+    const AEGraph *node = this;
+    for (size_t k = 0; k < where.size(); k++) {
+        if (where[k] >= node->num_subgraphs()) {
+            assert(k + 1 == where.size());
+            return node->atom_ids[where[k] - node->num_subgraphs()];
+        }
+        node = &node->subgraphs[where[k]];
+    }
+    return node->id;
+}
+
+bool AEGraph::find_node(uint64_t node_id, std::vector<int> &where) const {
+    // stores in <where> the current path to the node with the given id
+    std::vector<std::pair<const AEGraph*, int>> stack = {{this, 0}};
+    where.clear();
+    if (id == node_id)
+        return true;
+
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+
+        if (i == 0) {
+            for (int j = 0; j < node->num_atoms(); j++) {
+                if (node->atom_ids[j] == node_id) {
+                    where.push_back(node->num_subgraphs() + j);
+                    return true;
                 }
-                copy(r.begin(), r.end(), back_inserter(road));
             }
         }
+
+        if (i < node->num_subgraphs()) {
+            where.push_back(i);
+            if (node->subgraphs[i].id == node_id)
+                return true;
+            stack.push_back({&node->subgraphs[i], 0});
+        } else {
+            stack.pop_back();
+            if (!where.empty())
+                where.pop_back();
+        }
     }
-    for (int i = 0; i < num_atoms(); ++i) {
-        for (int j = 0; j < num_subgraphs(); ++j) {
-            auto r = subgraphs[j].get_paths_to(atoms[i]);
-            for (auto& v : r) {
-                v.insert(v.begin(), j);
+
+    return false;
+}
+
+std::map<uint64_t, std::vector<int>> AEGraph::node_paths() const {
+    // maps the id of every node to its current path, in a single traversal
+    std::map<uint64_t, std::vector<int>> paths;
+    std::vector<std::pair<const AEGraph*, std::vector<int>>> stack = {
+        {this, {}}};
+
+    while (!stack.empty()) {
+        auto top = std::move(stack.back());
+        stack.pop_back();
+        const AEGraph *node = top.first;
+
+        paths[node->id] = top.second;
+        for (int j = 0; j < node->num_atoms(); j++) {
+            auto path = top.second;
+            path.push_back(node->num_subgraphs() + j);
+            paths[node->atom_ids[j]] = path;
+        }
+        for (int i = 0; i < node->num_subgraphs(); i++) {
+            auto path = top.second;
+            path.push_back(i);
+            stack.push_back({&node->subgraphs[i], path});
+        }
+    }
+
+    return paths;
+}
+
+std::vector<uint64_t> AEGraph::node_ids(
+    const std::vector<std::vector<int>>& paths) const {
+    // translates rule sites to ids, which stay valid across rule steps
+    std::vector<uint64_t> ids;
+    for (const auto& path : paths) {
+        ids.push_back(node_id(path));
+    }
+    return ids;
+}
+
+AEGraph AEGraph::double_cut_node(uint64_t node_id) const {
+    std::vector<int> where;
+    bool found = find_node(node_id, where);
+    assert(found && !where.empty());
+    return double_cut(where);
+}
+
+AEGraph AEGraph::erase_node(uint64_t node_id) const {
+    std::vector<int> where;
+    bool found = find_node(node_id, where);
+    assert(found && !where.empty());
+    return erase(where);
+}
+
+AEGraph AEGraph::deiterate_node(uint64_t node_id) const {
+    std::vector<int> where;
+    bool found = find_node(node_id, where);
+    assert(found && !where.empty());
+    return deiterate(where);
+}
+
+bool AEGraph::can_double_cut(const std::vector<int>& where) const {
+    // checks a single site, without enumerating the others
+    const AEGraph *node = this;
+    for (int index : where) {
+        if (index < 0 || index >= node->num_subgraphs())
+            return false;
+        node = &node->subgraphs[index];
+    }
+    return !where.empty() && node->num_subgraphs() == 1 &&
+        node->num_atoms() == 0;
+}
+
+bool AEGraph::can_erase(const std::vector<int>& where) const {
+    // the parent area must be at an odd level (the sheet of assertion is
+    // at level -1) and, below the sheet, must not be left empty
+    if (where.empty() || where.size() % 2 == 0)
+        return false;
+
+    const AEGraph *node = this;
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        if (where[k] < 0 || where[k] >= node->num_subgraphs())
+            return false;
+        node = &node->subgraphs[where[k]];
+    }
+    return where.back() >= 0 && where.back() < node->size() &&
+        (where.size() == 1 || node->size() > 1);
+}
+
+bool AEGraph::can_deiterate(const std::vector<int>& where) const {
+    // the element at <where> must lie inside a subgraph of the sheet of
+    // assertion, must not be alone in its area and must have an equal copy
+    // directly on the sheet
+    if (where.size() < 2)
+        return false;
+
+    const AEGraph *node = this;
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        if (where[k] < 0 || where[k] >= node->num_subgraphs())
+            return false;
+        node = &node->subgraphs[where[k]];
+    }
+    int index = where.back();
+    if (index < 0 || index >= node->size() || node->size() < 2)
+        return false;
+
+    if (index >= node->num_subgraphs()) {
+        const std::string &atom = node->atoms[index - node->num_subgraphs()];
+        return std::binary_search(atoms.begin(), atoms.end(), atom);
+    }
+
+    const AEGraph &target = node->subgraphs[index];
+    for (const auto& sg : subgraphs) {
+        if (sg.hash_value == target.hash_value && sg == target)
+            return true;
+    }
+    return false;
+}
+
+bool AEGraph::valid_batch(const std::vector<RuleStep>& steps) const {
+    // a batch is valid when each step is a site of the original graph and
+    // applying them one after the other (double cuts first) would be legal
+    std::vector<RuleStep> sorted = steps;
+    std::sort(sorted.begin(), sorted.end(),
+        [](const RuleStep& a, const RuleStep& b) {
+            return a.second < b.second;
+        });
+
+    // (area, final size) of every area that loses elements
+    std::map<std::vector<int>, int> sizes;
+    std::set<int> touched_roots;
+    for (size_t k = 0; k < sorted.size(); k++) {
+        const std::string &rule = sorted[k].first;
+        const std::vector<int> &where = sorted[k].second;
+
+        if (!(rule == "DC" && can_double_cut(where)) &&
+            !(rule == "E" && can_erase(where)) &&
+            !(rule == "DE" && can_deiterate(where)))
+            return false;
+
+        // no step may be applied inside (or on) the element of another one
+        if (k > 0) {
+            const std::vector<int> &prev = sorted[k - 1].second;
+            if (prev.size() <= where.size() &&
+                std::equal(prev.begin(), prev.end(), where.begin()))
+                return false;
+        }
+        touched_roots.insert(where[0]);
+
+        std::vector<int> area(where.begin(), where.end() - 1);
+        const AEGraph *node = this;
+        for (int index : area) {
+            node = &node->subgraphs[index];
+        }
+        if (!sizes.count(area))
+            sizes[area] = node->size();
+        sizes[area]--;
+        if (rule == "DC")
+            sizes[area] += node->subgraphs[where.back()].subgraphs[0].size();
+    }
+
+    for (size_t k = 0; k < sorted.size(); k++) {
+        const std::string &rule = sorted[k].first;
+        const std::vector<int> &where = sorted[k].second;
+        std::vector<int> area(where.begin(), where.end() - 1);
+
+        // an emptied area means the last of its removals was illegal
+        if (rule != "DC" && !area.empty() && sizes[area] < 1)
+            return false;
+
+        if (rule != "DE")
+            continue;
+
+        // the copy on the sheet of assertion must survive the batch
+        const AEGraph *node = this;
+        for (int index : area) {
+            node = &node->subgraphs[index];
+        }
+        bool original = false;
+        int index = where.back();
+        if (index >= node->num_subgraphs()) {
+            int j = index - node->num_subgraphs();
+            const std::string &atom = node->atoms[j];
+            for (int i = 0; i < num_atoms() && !original; i++) {
+                original = atoms[i] == atom &&
+                    !touched_roots.count(num_subgraphs() + i);
+            }
+        } else {
+            const AEGraph &target = node->subgraphs[index];
+            for (int i = 0; i < num_subgraphs() && !original; i++) {
+                original = !touched_roots.count(i) &&
+                    subgraphs[i].hash_value == target.hash_value &&
+                    subgraphs[i] == target;
             }
-            copy(r.begin(), r.end(), back_inserter(road));
         }
+        if (!original)
+            return false;
     }
-    return road;
+
+    return true;
 }
 
-void AEGraph::deiterate_helper(std::vector<int> where, AEGraph &node) const {
-    if (where.capacity() != 1) {
-        unsigned int index;
-        index = where[0];
-        where.erase(where.begin());
-        node.deiterate_helper(where, node.subgraphs[index]);
-    } else if (where.capacity() == 1) {
-        if (node.num_subgraphs() - where[0] <= 0) {
-            node.atoms.erase(node.atoms.begin() -
-            node.num_subgraphs() + where[0]);
-        } else if (node.num_subgraphs() - where[0] > 0) {
-            node.subgraphs.erase(node.subgraphs.begin() + where[0]);
+AEGraph batch_helper(const AEGraph& root, const std::vector<RuleStep>& steps) {
+    // rebuilds the nodes that the (sorted) steps pass through, children
+    // before parents, with an explicit stack; subtrees without steps are
+    // copied as they are
+    struct Frame {
+        const AEGraph *node;
+        // the steps in [next_step, last) pass through the subgraphs of
+        // <node> from next_subgraph on
+        size_t next_step, last, depth;
+        int next_subgraph;
+        AEGraph result;
+        std::vector<AEGraph> changed;
+        std::vector<std::pair<std::string, uint64_t>> hoisted;
+    };
+    std::vector<Frame> stack;
+    auto open = [&](const AEGraph& node, size_t first, size_t last,
+        size_t depth) {
+        Frame frame = {&node, first, last, depth, 0,
+            AEGraph(node.is_SA ? "()" : "[]"), {}, {}};
+        frame.result.id = node.id;
+        stack.push_back(std::move(frame));
+    };
+    open(root, 0, steps.size(), 0);
+
+    while (true) {
+        Frame &f = stack.back();
+        const AEGraph &node = *f.node;
+        bool descended = false;
+        while (f.next_subgraph < node.num_subgraphs()) {
+            int i = f.next_subgraph++;
+            size_t k = f.next_step, end = k;
+            while (end < f.last && steps[end].second[f.depth] == i)
+                end++;
+            f.next_step = end;
+
+            if (end == k) {
+                // untouched children keep their (sorted) relative order
+                f.result.subgraphs.push_back(node.subgraphs[i]);
+            } else if (steps[k].second.size() > f.depth + 1) {
+                descended = true;
+                open(node.subgraphs[i], k, end, f.depth + 1);
+                break;
+            } else if (steps[k].first == "DC") {
+                const AEGraph &inner = node.subgraphs[i].subgraphs[0];
+                for (const auto& sg : inner.subgraphs) {
+                    f.changed.push_back(sg);
+                }
+                for (int j = 0; j < inner.num_atoms(); j++) {
+                    f.hoisted.push_back({inner.atoms[j], inner.atom_ids[j]});
+                }
+            }
+        }
+        if (descended)
+            continue;
+
+        size_t k = f.next_step;
+        for (int i = 0; i < node.num_atoms(); i++) {
+            if (k < f.last &&
+                steps[k].second[f.depth] == node.num_subgraphs() + i) {
+                k++;
+                continue;
+            }
+            f.result.atoms.push_back(node.atoms[i]);
+            f.result.atom_ids.push_back(node.atom_ids[i]);
         }
+
+        AEGraph result = std::move(f.result);
+        result.refresh();
+        for (auto& sg : f.changed) {
+            result.insert_subgraph(std::move(sg));
+        }
+        for (auto& atom : f.hoisted) {
+            result.insert_atom(std::move(atom.first), atom.second);
+        }
+
+        stack.pop_back();
+        if (stack.empty())
+            return result;
+        stack.back().changed.push_back(std::move(result));
     }
 }
 
-AEGraph AEGraph::deiterate(std::vector<int> where) const {
-    // 10p
-    AEGraph auxiliar = *this;
-    deiterate_helper(where, auxiliar);
-    return auxiliar;
+AEGraph AEGraph::apply_batch(const std::vector<RuleStep>& steps) const {
+    // applies independent steps, all given as paths into this graph, with
+    // a single copy of the graph
+    assert(valid_batch(steps));
+    if (steps.empty())
+        return *this;
+
+    std::vector<RuleStep> sorted = steps;
+    std::sort(sorted.begin(), sorted.end(),
+        [](const RuleStep& a, const RuleStep& b) {
+            return a.second < b.second;
+        });
+    return batch_helper(*this, sorted);
+}
+
+AEGraph AEGraph::apply_step(const RuleStep& step) const {
+    // one step of a proof; the rules keep the result in canonical order
+    return step.first == "DC" ? double_cut(step.second) :
+        step.first == "DE" ? deiterate(step.second) : erase(step.second);
 }
 
+AEGraph AEGraph::juxtapose(AEGraph first, AEGraph second) {
+    // puts the elements of both graphs on one sheet of assertion; the two
+    // sorted sequences are merged
+    std::vector<AEGraph*> merged;
+    for (auto& sg : first.subgraphs) {
+        merged.push_back(&sg);
+    }
+    size_t middle = merged.size();
+    for (auto& sg : second.subgraphs) {
+        merged.push_back(&sg);
+    }
+    std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end(),
+        [](const AEGraph* a, const AEGraph* b) { return *a < *b; });
+
+    AEGraph result("()");
+    for (AEGraph *sg : merged) {
+        result.subgraphs.push_back(std::move(*sg));
+    }
+
+    result.atoms.resize(first.num_atoms() + second.num_atoms());
+    result.atom_ids.resize(result.atoms.size());
+    size_t i = 0, j = 0;
+    for (size_t k = 0; k < result.atoms.size(); k++) {
+        // take from the first graph on ties, like a stable merge
+        if (j == second.atoms.size() ||
+            (i < first.atoms.size() && !(second.atoms[j] < first.atoms[i]))) {
+            result.atoms[k] = std::move(first.atoms[i]);
+            result.atom_ids[k] = first.atom_ids[i++];
+        } else {
+            result.atoms[k] = std::move(second.atoms[j]);
+            result.atom_ids[k] = second.atom_ids[j++];
+        }
+    }
+
+    // the cached sums of a sheet are sums over its elements
+    result.update_child(Contribution(), first.sums);
+    result.update_child(Contribution(), second.sums);
+    return result;
+}
+
+AEGraph AEGraph::enclose(AEGraph graph) {
+    // returns the sheet of assertion that holds <graph> inside a cut
+    AEGraph result("()");
+    graph.is_SA = false;
+    graph.update_child(Contribution(), Contribution());
+    Contribution added = graph.contribution();
+    result.subgraphs.push_back(std::move(graph));
+    result.update_child(Contribution(), added);
+    return result;
+}
+
+AEGraph AEGraph::counterset(AEGraph premise, AEGraph conclusion) {
+    // the premise together with the negated conclusion
+    return juxtapose(std::move(premise), enclose(std::move(conclusion)));
+}
+
+int AEGraph::count_double_cuts() const {
+    // same as possible_double_cuts().size(), from the cached sums
+    return sums.double_cuts;
+}
+
+int AEGraph::count_erasures(int level) const {
+    // same as possible_erasures(level).size(), from the cached sums
+    int own = 0;
+    if (level % 2 != 0 && !(level != -1 && size() == 1))
+        own = size();
+    return own + ((level + 1) % 2 == 0 ? sums.erasures[0] : sums.erasures[1]);
+}
+
+void AEGraph::visit_deiterations(
+    std::function<bool(const std::vector<int>&, int)> visit) const {
+    // calls visit(path, copies) for every element that can be deiterated,
+    // in lexicographic order, where <copies> is the number of originals on
+    // the sheet of assertion; stops as soon as visit() returns false
+    Engine::visit_deiterations(AEGraphStorage(), this, visit);
+}
+
+int AEGraph::count_deiterations() const {
+    // same as possible_deiterations().size(), without building the paths
+    int count = 0;
+    visit_deiterations([&](const std::vector<int>&, int copies) {
+        count += copies;
+        return true;
+    });
+    return count;
+}
+
+std::vector<int> AEGraph::nth_double_cut(int k) const {
+    // returns the k-th site (from 0) in lexicographic order, skipping
+    // whole subtrees by their cached counts; empty if there is none
+    std::vector<int> path;
+    const AEGraph *node = this;
+    while (k >= 0) {
+        bool descended = false;
+        for (int i = 0; i < node->num_subgraphs() && !descended; i++) {
+            const AEGraph &sg = node->subgraphs[i];
+            if (sg.num_subgraphs() == 1 && sg.num_atoms() == 0) {
+                if (k == 0) {
+                    path.push_back(i);
+                    return path;
+                }
+                k--;
+            }
+            if (k < sg.sums.double_cuts) {
+                path.push_back(i);
+                node = &sg;
+                descended = true;
+            } else {
+                k -= sg.sums.double_cuts;
+            }
+        }
+        if (!descended)
+            break;
+    }
+    return {};
+}
+
+std::vector<int> AEGraph::nth_erasure(int k, int level) const {
+    // same as possible_erasures(level)[k], walking down a single path
+    std::vector<int> path;
+    const AEGraph *node = this;
+    while (k >= 0) {
+        bool own = level % 2 != 0 && !(level != -1 && node->size() == 1);
+        bool descended = false;
+        for (int i = 0; i < node->size() && !descended; i++) {
+            if (own) {
+                if (k == 0) {
+                    path.push_back(i);
+                    return path;
+                }
+                k--;
+            }
+            if (i >= node->num_subgraphs())
+                continue;
+
+            int below = node->subgraphs[i].count_erasures(level + 1);
+            if (k < below) {
+                path.push_back(i);
+                node = &node->subgraphs[i];
+                level++;
+                descended = true;
+            } else {
+                k -= below;
+            }
+        }
+        if (!descended)
+            break;
+    }
+    return {};
+}
+
+std::vector<int> AEGraph::nth_deiteration(int k) const {
+    // stops the lexicographic walk at the k-th site
+    std::vector<int> result;
+    if (k < 0)
+        return result;
+
+    visit_deiterations([&](const std::vector<int>& path, int copies) {
+        if (k < copies) {
+            result = path;
+            return false;
+        }
+        k -= copies;
+        return true;
+    });
+    return result;
+}
+
+int AEGraph::total_size() const {
+    // number of atoms and cuts in the whole graph
+    return sums.nodes;
+}
+
+int AEGraph::total_atoms() const {
+    return sums.atoms;
+}
+
+int AEGraph::depth() const {
+    // how deeply the cuts are nested
+    return sums.height;
+}
+
+int height_without(const AEGraph& node, int index, int added) {
+    // the height <node> would have if subgraphs[index] were replaced by
+    // elements of height <added>
+    int height = added;
+    for (int i = 0; i < node.num_subgraphs(); i++) {
+        if (i != index)
+            height = std::max(height, node.subgraphs[i].sums.height + 1);
+    }
+    return height;
+}
+
+int predicted_depth(const AEGraph& root, const std::vector<int>& where,
+    int added) {
+    // the depth of <root> once the element at <where> is replaced by
+    // elements of height <added>; only the ancestors are looked at and the
+    // walk stops as soon as an ancestor keeps its height
+    std::vector<const AEGraph*> nodes = {&root};
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        nodes.push_back(&nodes.back()->subgraphs[where[k]]);
+    }
+
+    int height = added;
+    for (size_t k = where.size(); k > 0; k--) {
+        const AEGraph &node = *nodes[k - 1];
+        int index = where[k - 1];
+        int old = index < node.num_subgraphs() ?
+            node.subgraphs[index].sums.height + 1 : 0;
+        if (k < where.size())
+            height += 1;
+
+        if (old < node.sums.height && height <= node.sums.height)
+            return root.sums.height;
+        height = height_without(node, index, height);
+    }
+    return height;
+}
+
+StepEffect AEGraph::double_cut_effect(const std::vector<int>& where) const {
+    // a double cut removes two cuts and moves the inner contents up
+    const AEGraph *node = this;
+    for (int index : where) {
+        node = &node->subgraphs[index];
+    }
+    const AEGraph &inner = node->subgraphs[0];
+
+    StepEffect effect;
+    effect.size = -2;
+    effect.atoms = 0;
+    effect.depth = predicted_depth(*this, where, inner.sums.height) -
+        sums.height;
+    return effect;
+}
+
+StepEffect AEGraph::erase_effect(const std::vector<int>& where) const {
+    // the erased element takes its whole subtree with it
+    const AEGraph *node = this;
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        node = &node->subgraphs[where[k]];
+    }
+
+    StepEffect effect;
+    if (where.back() < node->num_subgraphs()) {
+        const AEGraph &sg = node->subgraphs[where.back()];
+        effect.size = -(sg.sums.nodes + 1);
+        effect.atoms = -sg.sums.atoms;
+    } else {
+        effect.size = -1;
+        effect.atoms = -1;
+    }
+    effect.depth = predicted_depth(*this, where, 0) - sums.height;
+    return effect;
+}
+
+StepEffect AEGraph::deiterate_effect(const std::vector<int>& where) const {
+    // deiteration removes the copy just like an erasure
+    return erase_effect(where);
+}
+
+StepEffect AEGraph::step_effect(const RuleStep& step) const {
+    if (step.first == "DC")
+        return double_cut_effect(step.second);
+    if (step.first == "DE")
+        return deiterate_effect(step.second);
+    return erase_effect(step.second);
+}
@@ -4,21 +4,81 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <functional>
+
+uint64_t atom_hash(const std::string& atom);
+// the splitmix64 finalizer
+uint64_t mix64(uint64_t x);
+// deletes whitespace from the beginning and end of the string
+std::string strip(std::string s);
+
+// a rule ("DC", "E" or "DE") together with the path it is applied at
+using RuleStep = std::pair<std::string, std::vector<int>>;
+
+// how a rule step changes total_size(), depth() and total_atoms()
+struct StepEffect {
+    int size;
+    int depth;
+    int atoms;
+};
 
 class AEGraph {
  public:
     explicit AEGraph(std::string representation);
 
+    // the implicit versions recurse once per nesting level, which
+    // overflows the stack on deep graphs
+    AEGraph(const AEGraph& other);
+    AEGraph(AEGraph&& other) noexcept = default;
+    AEGraph& operator=(const AEGraph& other);
+    AEGraph& operator=(AEGraph&& other) noexcept;
+    ~AEGraph();
+
     std::string repr() const;
+    // repr() of the subgraph, built when first asked for and kept until
+    // update_child() drops it; the comparisons read a kept label but never
+    // build one
+    const std::string& label() const;
+    bool has_label() const;
 
     void sort();
+    void compact();
+    void insert_atom(std::string atom, uint64_t atom_id = 0);
+    void insert_subgraph(AEGraph subgraph);
+    void remove_atom(int index);
+    void remove_subgraph(int index);
+    int reposition(int index);
 
+    AEGraph take_subgraph(int index);
+
+    // what a subtree adds to the cached sums of its parent
+    struct Contribution {
+        uint64_t hash;
+        int double_cuts;
+        int erasures[2];
+        int nodes;
+        int atoms;
+        int height;
+    };
+    Contribution contribution() const;
+    static Contribution atom_contribution(const std::string& atom);
+    void refresh();
+    void update_child(const Contribution& removed, const Contribution& added);
+
+    uint64_t hash() const;
+
+    // the order of repr(); == checks the hashes first
     bool operator<(const AEGraph& other) const;
     bool operator==(const AEGraph& other) const;
     bool operator!=(const AEGraph& other) const;
     AEGraph operator[](const int index) const;
 
     bool contains(const AEGraph& other) const;
+    bool equivalent(const AEGraph& other) const;
     bool contains(const std::string other) const;
 
     int num_subgraphs() const;
@@ -36,15 +96,75 @@ class AEGraph {
     std::vector<std::vector<int>> possible_deiterations() const;
     void deiterate_helper(std::vector<int> where, AEGraph &node) const;
     AEGraph deiterate(std::vector<int> where) const;
+
+    int count_double_cuts() const;
+    int count_erasures(int level = -1) const;
+    int count_deiterations() const;
+    void visit_deiterations(
+        std::function<bool(const std::vector<int>&, int)> visit) const;
+    std::vector<int> nth_double_cut(int k) const;
+    std::vector<int> nth_erasure(int k, int level = -1) const;
+    std::vector<int> nth_deiteration(int k) const;
+
+    int total_size() const;
+    int total_atoms() const;
+    int depth() const;
+    StepEffect double_cut_effect(const std::vector<int>& where) const;
+    StepEffect erase_effect(const std::vector<int>& where) const;
+    StepEffect deiterate_effect(const std::vector<int>& where) const;
+    StepEffect step_effect(const RuleStep& step) const;
     std::vector<std::vector<int>> get_paths_to(const std::string other) const;
     std::vector<std::vector<int>> get_paths_to(const AEGraph& other) const;
 
+    static uint64_t new_id();
+    std::vector<uint64_t> renumber();
+    uint64_t node_id(const std::vector<int>& where) const;
+    bool find_node(uint64_t node_id, std::vector<int> &where) const;
+    std::map<uint64_t, std::vector<int>> node_paths() const;
+    std::vector<uint64_t> node_ids(
+        const std::vector<std::vector<int>>& paths) const;
+
+    AEGraph double_cut_node(uint64_t node_id) const;
+    AEGraph erase_node(uint64_t node_id) const;
+    AEGraph deiterate_node(uint64_t node_id) const;
+
+    bool can_double_cut(const std::vector<int>& where) const;
+    bool can_erase(const std::vector<int>& where) const;
+    bool can_deiterate(const std::vector<int>& where) const;
+    bool valid_batch(const std::vector<RuleStep>& steps) const;
+    AEGraph apply_batch(const std::vector<RuleStep>& steps) const;
+    AEGraph apply_step(const RuleStep& step) const;
+
+    static AEGraph juxtapose(AEGraph first, AEGraph second);
+    static AEGraph enclose(AEGraph graph);
+    static AEGraph counterset(AEGraph premise, AEGraph conclusion);
+
     std::vector<std::string> atoms;
     std::vector<AEGraph> subgraphs;
 
     friend std::ostream& operator<<(std::ostream &out, const AEGraph &g);
+    // graph literals build their nodes directly
+    template <size_t N> friend struct StaticGraph;
 
     bool is_SA;
+
+    // stable ids of this node and of its atoms; they follow the nodes
+    // through sort() and through the rules, unlike positional paths
+    uint64_t id;
+    std::vector<uint64_t> atom_ids;
+
+    // order independent hash of the subtree and the sums of the children's
+    // contributions (hash, site counts) behind it; kept up to date by
+    // sort() and by the rule helpers
+    uint64_t hash_value;
+    Contribution sums;
+
+ private:
+    // an empty cut without an id, filled in by the parser and by copies
+    AEGraph();
+
+    // shared by the copies of a node, which have the same label
+    mutable std::shared_ptr<const std::string> label_cache;
 };
 
 #endif  // AEGRAPH_H_
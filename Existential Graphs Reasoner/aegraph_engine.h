@@ -0,0 +1,981 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef AEGRAPH_ENGINE_H_
+#define AEGRAPH_ENGINE_H_
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "./aegraph.h"
+
+// The enumerators, the rules, contains() and get_paths_to() of AEGraph,
+// written once as templates over two policies: how atoms are stored and
+// compared, and how the cuts are laid out in memory. AEGraph runs them on
+// its own nodes through AEGraphStorage; GraphEngine owns a NestedStorage or
+// an ArenaStorage and runs them on that. Every storage keeps the canonical
+// order of AEGraph (atoms by name, subgraphs by their representation), so
+// they all find the same sites and build the same graphs.
+
+// atoms kept as their names
+struct StringAtoms {
+    using Atom = std::string;
+
+    static Atom make(const std::string& name) { return name; }
+    static const std::string& name(const Atom& atom) { return atom; }
+    static bool equal(const Atom& a, const Atom& b) { return a == b; }
+    static bool less(const Atom& a, const Atom& b) { return a < b; }
+};
+
+// atoms kept as indices into a table shared by every graph, so equal atoms
+// are compared as integers
+struct InternedAtoms {
+    using Atom = uint32_t;
+
+    static Atom make(const std::string& name) {
+        auto it = ids().find(name);
+        if (it != ids().end())
+            return it->second;
+        Atom atom = names().size();
+        names().push_back(name);
+        ids().emplace(name, atom);
+        return atom;
+    }
+    static const std::string& name(Atom atom) { return names()[atom]; }
+    static bool equal(Atom a, Atom b) { return a == b; }
+    static bool less(Atom a, Atom b) {
+        return a != b && names()[a] < names()[b];
+    }
+
+ private:
+    // a deque, so the names handed out by name() are never moved
+    static std::deque<std::string>& names() {
+        static std::deque<std::string> table;
+        return table;
+    }
+    static std::unordered_map<std::string, Atom>& ids() {
+        static std::unordered_map<std::string, Atom> table;
+        return table;
+    }
+};
+
+// Every storage policy offers the same interface to GraphAlgorithms. The
+// reads go through a const storage and ConstNode handles:
+//   child(node, i), num_subgraphs(node), atoms(node), is_SA(node),
+//   key(node) (a cached hash of the subtree, or 0 when there is none),
+//   label(node) (its representation, which orders the siblings) and
+//   kept_label(node) (that representation if it is already kept, or null).
+// The writes go through a non-const storage and Node handles:
+//   take_subgraph(area, i) and put_subgraph(area, i, entry), remove_atom()
+//   and put_atom(), move_subgraph(area, from, to), entry_node(entry) and
+//   entry_atom(atom) for elements out of their area, take_subgraphs() and
+//   take_atoms() to empty a node that is dropped next, drop(entry), and
+//   summary(node) and update(parent, old, child) to keep whatever a parent
+//   caches about its children.
+
+template <class Storage>
+struct GraphAlgorithms;
+
+// for the storages that cache nothing about the children of a node
+struct NoSummary {};
+
+template <class T>
+void rotate_entry(std::vector<T> *entries, int from, int to) {
+    // moves (*entries)[from] to index <to>, shifting the ones in between
+    auto begin = entries->begin();
+    if (to < from)
+        std::rotate(begin + to, begin + from, begin + from + 1);
+    else if (from < to)
+        std::rotate(begin + from, begin + from + 1, begin + to + 1);
+}
+
+// each cut owns its subgraphs, like AEGraph does
+template <class AtomPolicy>
+class NestedStorage {
+ public:
+    using Atoms = AtomPolicy;
+    using Atom = typename Atoms::Atom;
+    struct Cut {
+        std::vector<Cut> subgraphs;
+        std::vector<Atom> atoms;
+        bool is_SA;
+    };
+    using Node = Cut*;
+    using ConstNode = const Cut*;
+    using Entry = Cut;
+    using AtomEntry = Atom;
+    using Summary = NoSummary;
+
+    explicit NestedStorage(const AEGraph& graph) {
+        std::vector<std::pair<const AEGraph*, Cut*>> stack = {
+            {&graph, &sheet}};
+        while (!stack.empty()) {
+            const AEGraph *from = stack.back().first;
+            Cut *to = stack.back().second;
+            stack.pop_back();
+
+            to->is_SA = from->is_SA;
+            for (const auto& atom : from->atoms) {
+                to->atoms.push_back(Atoms::make(atom));
+            }
+            to->subgraphs.resize(from->num_subgraphs());
+            for (int i = 0; i < from->num_subgraphs(); i++) {
+                stack.push_back({&from->subgraphs[i], &to->subgraphs[i]});
+            }
+        }
+    }
+
+    // the implicit copy and destructor of Cut would recurse once per level
+    NestedStorage(const NestedStorage& other) {
+        std::vector<std::pair<const Cut*, Cut*>> stack = {
+            {&other.sheet, &sheet}};
+        while (!stack.empty()) {
+            const Cut *from = stack.back().first;
+            Cut *to = stack.back().second;
+            stack.pop_back();
+
+            to->is_SA = from->is_SA;
+            to->atoms = from->atoms;
+            to->subgraphs.resize(from->subgraphs.size());
+            for (size_t i = 0; i < from->subgraphs.size(); i++) {
+                stack.push_back({&from->subgraphs[i], &to->subgraphs[i]});
+            }
+        }
+    }
+    NestedStorage(NestedStorage&& other) noexcept
+        : sheet(std::move(other.sheet)) {}
+    NestedStorage& operator=(NestedStorage other) {
+        std::swap(sheet, other.sheet);
+        return *this;
+    }
+    ~NestedStorage() {
+        release(sheet.subgraphs);
+    }
+
+    ConstNode root() const { return &sheet; }
+    Node root() { return &sheet; }
+    ConstNode child(ConstNode node, int index) const {
+        return &node->subgraphs[index];
+    }
+    Node child(Node node, int index) { return &node->subgraphs[index]; }
+    int num_subgraphs(ConstNode node) const {
+        return node->subgraphs.size();
+    }
+    const std::vector<Atom>& atoms(ConstNode node) const {
+        return node->atoms;
+    }
+    bool is_SA(ConstNode node) const { return node->is_SA; }
+    uint64_t key(ConstNode) const { return 0; }
+    std::string label(ConstNode node) const {
+        return GraphAlgorithms<NestedStorage>::repr(*this, node);
+    }
+    const std::string* kept_label(ConstNode) const { return nullptr; }
+
+    Entry take_subgraph(Node area, int index) {
+        Entry entry = std::move(area->subgraphs[index]);
+        area->subgraphs.erase(area->subgraphs.begin() + index);
+        return entry;
+    }
+    void put_subgraph(Node area, int index, Entry&& entry) {
+        area->subgraphs.insert(area->subgraphs.begin() + index,
+            std::move(entry));
+    }
+    void remove_atom(Node area, int index) {
+        area->atoms.erase(area->atoms.begin() + index);
+    }
+    void put_atom(Node area, int index, AtomEntry&& atom) {
+        area->atoms.insert(area->atoms.begin() + index, std::move(atom));
+    }
+    void move_subgraph(Node area, int from, int to) {
+        rotate_entry(&area->subgraphs, from, to);
+    }
+    ConstNode entry_node(const Entry& entry) const { return &entry; }
+    Node entry_node(Entry& entry) { return &entry; }
+    const Atom& entry_atom(const AtomEntry& atom) const { return atom; }
+    std::vector<Entry> take_subgraphs(Node node) {
+        std::vector<Entry> entries = std::move(node->subgraphs);
+        node->subgraphs.clear();
+        return entries;
+    }
+    std::vector<AtomEntry> take_atoms(Node node) {
+        return std::move(node->atoms);
+    }
+    void drop(Entry&& entry) {
+        std::vector<Cut> pending;
+        pending.push_back(std::move(entry));
+        release(pending);
+    }
+    Summary summary(ConstNode) const { return Summary(); }
+    void update(Node, const Summary&, ConstNode) {}
+
+ private:
+    static void release(std::vector<Cut>& pending) {
+        // empties every cut before it is destroyed
+        while (!pending.empty()) {
+            std::vector<Cut> children = std::move(pending.back().subgraphs);
+            pending.pop_back();
+            for (auto& cut : children) {
+                pending.push_back(std::move(cut));
+            }
+        }
+    }
+
+    Cut sheet;
+};
+
+// all cuts in a single vector, linking their subgraphs by index; copying a
+// graph copies one vector of cuts
+template <class AtomPolicy>
+class ArenaStorage {
+ public:
+    using Atoms = AtomPolicy;
+    using Atom = typename Atoms::Atom;
+    struct Cut {
+        std::vector<int> subgraphs;
+        std::vector<Atom> atoms;
+        bool is_SA;
+    };
+    using Node = int;
+    using ConstNode = int;
+    using Entry = int;
+    using AtomEntry = Atom;
+    using Summary = NoSummary;
+
+    explicit ArenaStorage(const AEGraph& graph) : cuts(1) {
+        // the subgraphs of a cut are stored next to each other
+        std::vector<std::pair<const AEGraph*, int>> stack = {{&graph, 0}};
+        while (!stack.empty()) {
+            const AEGraph *from = stack.back().first;
+            int to = stack.back().second;
+            stack.pop_back();
+
+            cuts[to].is_SA = from->is_SA;
+            for (const auto& atom : from->atoms) {
+                cuts[to].atoms.push_back(Atoms::make(atom));
+            }
+            for (const auto& sg : from->subgraphs) {
+                int index = cuts.size();
+                cuts.push_back(Cut());
+                cuts[to].subgraphs.push_back(index);
+                stack.push_back({&sg, index});
+            }
+        }
+    }
+
+    Node root() const { return 0; }
+    Node child(Node node, int index) const {
+        return cuts[node].subgraphs[index];
+    }
+    int num_subgraphs(Node node) const {
+        return cuts[node].subgraphs.size();
+    }
+    const std::vector<Atom>& atoms(Node node) const {
+        return cuts[node].atoms;
+    }
+    bool is_SA(Node node) const { return cuts[node].is_SA; }
+    uint64_t key(Node) const { return 0; }
+    std::string label(Node node) const {
+        return GraphAlgorithms<ArenaStorage>::repr(*this, node);
+    }
+    const std::string* kept_label(Node) const { return nullptr; }
+
+    Entry take_subgraph(Node area, int index) {
+        auto &entries = cuts[area].subgraphs;
+        Entry entry = entries[index];
+        entries.erase(entries.begin() + index);
+        return entry;
+    }
+    void put_subgraph(Node area, int index, Entry&& entry) {
+        auto &entries = cuts[area].subgraphs;
+        entries.insert(entries.begin() + index, entry);
+    }
+    void remove_atom(Node area, int index) {
+        auto &atoms = cuts[area].atoms;
+        atoms.erase(atoms.begin() + index);
+    }
+    void put_atom(Node area, int index, AtomEntry&& atom) {
+        auto &atoms = cuts[area].atoms;
+        atoms.insert(atoms.begin() + index, std::move(atom));
+    }
+    void move_subgraph(Node area, int from, int to) {
+        rotate_entry(&cuts[area].subgraphs, from, to);
+    }
+    Node entry_node(const Entry& entry) const { return entry; }
+    const Atom& entry_atom(const AtomEntry& atom) const { return atom; }
+    std::vector<Entry> take_subgraphs(Node node) {
+        std::vector<Entry> entries = std::move(cuts[node].subgraphs);
+        cuts[node].subgraphs.clear();
+        return entries;
+    }
+    std::vector<AtomEntry> take_atoms(Node node) {
+        return std::move(cuts[node].atoms);
+    }
+    // a dropped cut stays in the arena, unreachable, until the graph is
+    // built again
+    void drop(Entry&&) {}
+    Summary summary(Node) const { return Summary(); }
+    void update(Node, const Summary&, Node) {}
+
+ private:
+    std::vector<Cut> cuts;
+};
+
+// the nodes of an AEGraph themselves; every write keeps the cached sums and
+// labels of the touched node up to date through update_child()
+class AEGraphStorage {
+ public:
+    using Atoms = StringAtoms;
+    using Atom = std::string;
+    using Node = AEGraph*;
+    using ConstNode = const AEGraph*;
+    using Entry = AEGraph;
+    // an atom with its id
+    using AtomEntry = std::pair<std::string, uint64_t>;
+    using Summary = AEGraph::Contribution;
+
+    ConstNode child(ConstNode node, int index) const {
+        return &node->subgraphs[index];
+    }
+    Node child(Node node, int index) { return &node->subgraphs[index]; }
+    int num_subgraphs(ConstNode node) const { return node->num_subgraphs(); }
+    const std::vector<Atom>& atoms(ConstNode node) const {
+        return node->atoms;
+    }
+    bool is_SA(ConstNode node) const { return node->is_SA; }
+    uint64_t key(ConstNode node) const { return node->hash_value; }
+    const std::string& label(ConstNode node) const { return node->label(); }
+    const std::string* kept_label(ConstNode node) const {
+        return node->has_label() ? &node->label() : nullptr;
+    }
+
+    Entry take_subgraph(Node area, int index) {
+        return area->take_subgraph(index);
+    }
+    void put_subgraph(Node area, int index, Entry&& entry) {
+        AEGraph::Contribution added = entry.contribution();
+        area->subgraphs.insert(area->subgraphs.begin() + index,
+            std::move(entry));
+        area->update_child(AEGraph::Contribution(), added);
+    }
+    void remove_atom(Node area, int index) { area->remove_atom(index); }
+    void put_atom(Node area, int index, AtomEntry&& atom) {
+        AEGraph::Contribution added = AEGraph::atom_contribution(atom.first);
+        area->atom_ids.insert(area->atom_ids.begin() + index,
+            atom.second ? atom.second : AEGraph::new_id());
+        area->atoms.insert(area->atoms.begin() + index,
+            std::move(atom.first));
+        area->update_child(AEGraph::Contribution(), added);
+    }
+    // the label of <area> was already dropped by the change that moved
+    // the subgraph
+    void move_subgraph(Node area, int from, int to) {
+        rotate_entry(&area->subgraphs, from, to);
+    }
+    ConstNode entry_node(const Entry& entry) const { return &entry; }
+    Node entry_node(Entry& entry) { return &entry; }
+    const Atom& entry_atom(const AtomEntry& atom) const { return atom.first; }
+    // the sums of <node> are left stale; it is dropped right after
+    std::vector<Entry> take_subgraphs(Node node) {
+        std::vector<Entry> entries = std::move(node->subgraphs);
+        node->subgraphs.clear();
+        return entries;
+    }
+    std::vector<AtomEntry> take_atoms(Node node) {
+        std::vector<AtomEntry> entries;
+        for (int i = 0; i < node->num_atoms(); i++) {
+            entries.push_back({std::move(node->atoms[i]),
+                node->atom_ids[i]});
+        }
+        node->atoms.clear();
+        node->atom_ids.clear();
+        return entries;
+    }
+    // the destructor of AEGraph does not recurse
+    void drop(Entry&&) {}
+    Summary summary(ConstNode node) const { return node->contribution(); }
+    void update(Node parent, const Summary& old, ConstNode child) {
+        parent->update_child(old, child->contribution());
+    }
+};
+
+template <class Storage>
+struct GraphAlgorithms {
+    using Atoms = typename Storage::Atoms;
+    using Atom = typename Storage::Atom;
+    using Node = typename Storage::Node;
+    using ConstNode = typename Storage::ConstNode;
+    using Entry = typename Storage::Entry;
+    using AtomEntry = typename Storage::AtomEntry;
+    using Summary = typename Storage::Summary;
+    using Paths = std::vector<std::vector<int>>;
+
+    static int size(const Storage& s, ConstNode node) {
+        return s.num_subgraphs(node) + s.atoms(node).size();
+    }
+
+    static std::string repr(const Storage& s, ConstNode root,
+        bool use_labels = false) {
+        // the serialized representation of <root>; the areas that are still
+        // being written are kept on a stack, together with the next
+        // subgraph to write. With <use_labels>, a subgraph whose label is
+        // kept is copied instead of being written again.
+        std::string result(1, s.is_SA(root) ? '(' : '[');
+        std::vector<std::pair<ConstNode, int>> stack = {{root, 0}};
+        while (!stack.empty()) {
+            ConstNode node = stack.back().first;
+            int i = stack.back().second++;
+
+            if (i < s.num_subgraphs(node)) {
+                if (i > 0)
+                    result += ", ";
+                ConstNode sg = s.child(node, i);
+                const std::string *label = use_labels ? s.kept_label(sg) :
+                    nullptr;
+                if (label) {
+                    result += *label;
+                    continue;
+                }
+                result += s.is_SA(sg) ? '(' : '[';
+                stack.push_back({sg, 0});
+                continue;
+            }
+
+            const auto& atoms = s.atoms(node);
+            for (size_t j = 0; j < atoms.size(); j++) {
+                if (i > 0 || j > 0)
+                    result += ", ";
+                result += Atoms::name(atoms[j]);
+            }
+            result += s.is_SA(node) ? ')' : ']';
+            stack.pop_back();
+        }
+        return result;
+    }
+
+    // reads the representation of a subtree piece by piece (brackets,
+    // separators, atoms and the labels its subgraphs keep) in the order
+    // repr() writes them, without putting it together
+    class Reader {
+     public:
+        Reader(const Storage& s, ConstNode root) : s(s), next_piece(0) {
+            const std::string *label = s.kept_label(root);
+            if (label) {
+                pieces.push_back({label->data(), label->size()});
+            } else {
+                pieces.push_back({s.is_SA(root) ? "(" : "[", 1});
+                stack.push_back({root, 0});
+            }
+        }
+
+        // the next piece, or false at the end of the representation
+        bool next(const char **text, size_t *size) {
+            while (next_piece == pieces.size()) {
+                if (stack.empty())
+                    return false;
+                pieces.clear();
+                next_piece = 0;
+                step();
+            }
+            *text = pieces[next_piece].first;
+            *size = pieces[next_piece].second;
+            next_piece++;
+            return true;
+        }
+
+     private:
+        void step() {
+            // one iteration of the loop in repr()
+            ConstNode node = stack.back().first;
+            int i = stack.back().second++;
+            if (i < s.num_subgraphs(node)) {
+                if (i > 0)
+                    pieces.push_back({", ", 2});
+                ConstNode sg = s.child(node, i);
+                const std::string *label = s.kept_label(sg);
+                if (label) {
+                    pieces.push_back({label->data(), label->size()});
+                } else {
+                    pieces.push_back({s.is_SA(sg) ? "(" : "[", 1});
+                    stack.push_back({sg, 0});
+                }
+                return;
+            }
+
+            const auto& atoms = s.atoms(node);
+            for (size_t j = 0; j < atoms.size(); j++) {
+                if (i > 0 || j > 0)
+                    pieces.push_back({", ", 2});
+                const std::string &name = Atoms::name(atoms[j]);
+                pieces.push_back({name.data(), name.size()});
+            }
+            pieces.push_back({s.is_SA(node) ? ")" : "]", 1});
+            stack.pop_back();
+        }
+
+        const Storage& s;
+        std::vector<std::pair<ConstNode, int>> stack;
+        std::vector<std::pair<const char*, size_t>> pieces;
+        size_t next_piece;
+    };
+
+    static int compare(const Storage& s, ConstNode a, ConstNode b) {
+        // the sign of repr(a).compare(repr(b)): both are read side by side
+        // up to their first difference, so no label is built
+        Reader first(s, a), second(s, b);
+        const char *x = nullptr, *y = nullptr;
+        size_t m = 0, n = 0;
+        while (true) {
+            bool more_first = m > 0 || first.next(&x, &m);
+            bool more_second = n > 0 || second.next(&y, &n);
+            if (!more_first || !more_second)
+                return more_first - more_second;
+
+            size_t common = std::min(m, n);
+            int order = std::memcmp(x, y, common);
+            if (order != 0)
+                return order;
+            x += common;
+            y += common;
+            m -= common;
+            n -= common;
+        }
+    }
+
+    static bool same(const Storage& a, ConstNode x, const Storage& b,
+        ConstNode y) {
+        // both subtrees are in canonical order, so they are equal exactly
+        // when they match node by node
+        if (a.key(x) != b.key(y))
+            return false;
+        std::vector<std::pair<ConstNode, ConstNode>> stack = {{x, y}};
+        while (!stack.empty()) {
+            ConstNode u = stack.back().first;
+            ConstNode v = stack.back().second;
+            stack.pop_back();
+
+            const auto& atoms_u = a.atoms(u);
+            const auto& atoms_v = b.atoms(v);
+            if (a.is_SA(u) != b.is_SA(v) ||
+                a.num_subgraphs(u) != b.num_subgraphs(v) ||
+                atoms_u.size() != atoms_v.size())
+                return false;
+            for (size_t j = 0; j < atoms_u.size(); j++)
+                if (!Atoms::equal(atoms_u[j], atoms_v[j]))
+                    return false;
+            for (int i = 0; i < a.num_subgraphs(u); i++)
+                stack.push_back({a.child(u, i), b.child(v, i)});
+        }
+        return true;
+    }
+
+    static bool contains(const Storage& s, ConstNode root,
+        const Atom& atom) {
+        // checks if an atom is in a graph
+        std::vector<ConstNode> stack = {root};
+        while (!stack.empty()) {
+            ConstNode node = stack.back();
+            stack.pop_back();
+
+            for (const auto& a : s.atoms(node))
+                if (Atoms::equal(a, atom))
+                    return true;
+            for (int i = 0; i < s.num_subgraphs(node); i++)
+                stack.push_back(s.child(node, i));
+        }
+        return false;
+    }
+
+    static bool contains(const Storage& s, ConstNode root,
+        const Storage& other, ConstNode other_root) {
+        // checks if a subgraph is in a graph; only the subgraphs with the
+        // same key are compared
+        std::vector<ConstNode> stack = {root};
+        while (!stack.empty()) {
+            ConstNode node = stack.back();
+            stack.pop_back();
+
+            for (int i = 0; i < s.num_subgraphs(node); i++) {
+                ConstNode sg = s.child(node, i);
+                if (same(s, sg, other, other_root))
+                    return true;
+                stack.push_back(sg);
+            }
+        }
+        return false;
+    }
+
+    static Paths get_paths_to(const Storage& s, ConstNode root,
+        const Atom& atom) {
+        // returns all paths in the tree that lead to <atom>; the atoms of
+        // an area are listed before the paths inside its subgraphs
+        Paths paths;
+        std::vector<int> path;
+        std::vector<std::pair<ConstNode, int>> stack = {{root, 0}};
+
+        while (!stack.empty()) {
+            ConstNode node = stack.back().first;
+            int i = stack.back().second++;
+            int len_subgraphs = s.num_subgraphs(node);
+            const auto& atoms = s.atoms(node);
+
+            if (i == 0 && size(s, node) > 1) {
+                for (size_t j = 0; j < atoms.size(); j++) {
+                    if (Atoms::equal(atoms[j], atom)) {
+                        path.push_back(j + len_subgraphs);
+                        paths.push_back(path);
+                        path.pop_back();
+                    }
+                }
+            }
+
+            if (i < len_subgraphs) {
+                path.push_back(i);
+                stack.push_back({s.child(node, i), 0});
+            } else {
+                stack.pop_back();
+                if (!path.empty())
+                    path.pop_back();
+            }
+        }
+        return paths;
+    }
+
+    static Paths get_paths_to(const Storage& s, ConstNode root,
+        const Storage& other, ConstNode other_root) {
+        // returns all paths in the tree that lead to a subgraph like
+        // <other_root>
+        Paths paths;
+        std::vector<int> path;
+        std::vector<std::pair<ConstNode, int>> stack = {{root, 0}};
+
+        while (!stack.empty()) {
+            ConstNode node = stack.back().first;
+            int i = stack.back().second++;
+            if (i >= s.num_subgraphs(node)) {
+                stack.pop_back();
+                if (!path.empty())
+                    path.pop_back();
+                continue;
+            }
+
+            ConstNode sg = s.child(node, i);
+            path.push_back(i);
+            if (size(s, node) > 1 && same(s, sg, other, other_root)) {
+                paths.push_back(path);
+                path.pop_back();
+            } else {
+                stack.push_back({sg, 0});
+            }
+        }
+        return paths;
+    }
+
+    static Paths possible_double_cuts(const Storage& s, ConstNode root) {
+        // a cut is listed before the sites inside it, so the sites come out
+        // in lexicographic order
+        Paths road;
+        std::vector<int> path;
+        std::vector<std::pair<ConstNode, int>> stack = {{root, 0}};
+        while (!stack.empty()) {
+            ConstNode node = stack.back().first;
+            int i = stack.back().second++;
+            if (i >= s.num_subgraphs(node)) {
+                stack.pop_back();
+                if (!path.empty())
+                    path.pop_back();
+                continue;
+            }
+
+            ConstNode sg = s.child(node, i);
+            path.push_back(i);
+            if (s.num_subgraphs(sg) == 1 && s.atoms(sg).empty())
+                road.push_back(path);
+            stack.push_back({sg, 0});
+        }
+        return road;
+    }
+
+    static Paths possible_erasures(const Storage& s, ConstNode root,
+        int level) {
+        // lexicographic order, like possible_double_cuts(); the level of an
+        // area is <level> plus the length of its path
+        Paths road;
+        std::vector<int> path;
+        std::vector<std::pair<ConstNode, int>> stack = {{root, 0}};
+        while (!stack.empty()) {
+            ConstNode node = stack.back().first;
+            int i = stack.back().second++;
+            int node_level = level + static_cast<int>(path.size());
+            if (i >= size(s, node)) {
+                stack.pop_back();
+                if (!path.empty())
+                    path.pop_back();
+                continue;
+            }
+
+            path.push_back(i);
+            if (node_level % 2 != 0 &&
+                !(node_level != -1 && size(s, node) == 1))
+                road.push_back(path);
+            if (i < s.num_subgraphs(node)) {
+                stack.push_back({s.child(node, i), 0});
+            } else {
+                path.pop_back();
+            }
+        }
+        return road;
+    }
+
+    template <class Visit>
+    static void visit_deiterations(const Storage& s, ConstNode root,
+        Visit visit) {
+        // calls visit(path, copies) for every element that can be
+        // deiterated, in lexicographic order, where <copies> is the number
+        // of originals on the sheet of assertion; stops as soon as visit()
+        // returns false
+        const auto& root_atoms = s.atoms(root);
+        std::unordered_multimap<uint64_t, ConstNode> root_subgraphs;
+        for (int j = 0; j < s.num_subgraphs(root); j++) {
+            ConstNode sg = s.child(root, j);
+            root_subgraphs.emplace(s.key(sg), sg);
+        }
+
+        std::vector<int> path;
+        std::vector<std::pair<ConstNode, int>> stack;
+        for (int j = 0; j < s.num_subgraphs(root); j++) {
+            path.assign(1, j);
+            stack.assign(1, {s.child(root, j), 0});
+
+            while (!stack.empty()) {
+                ConstNode node = stack.back().first;
+                int i = stack.back().second++;
+                if (i >= size(s, node)) {
+                    stack.pop_back();
+                    path.pop_back();
+                    continue;
+                }
+
+                path.push_back(i);
+                int copies = 0;
+                int len_subgraphs = s.num_subgraphs(node);
+                if (size(s, node) > 1 && i < len_subgraphs) {
+                    ConstNode sg = s.child(node, i);
+                    auto range = root_subgraphs.equal_range(s.key(sg));
+                    for (auto it = range.first; it != range.second; ++it)
+                        copies += same(s, it->second, s, sg);
+                } else if (size(s, node) > 1) {
+                    // the atoms of the sheet are sorted by name
+                    const Atom &atom = s.atoms(node)[i - len_subgraphs];
+                    auto range = std::equal_range(root_atoms.begin(),
+                        root_atoms.end(), atom, Atoms::less);
+                    copies = range.second - range.first;
+                }
+
+                if (copies && !visit(path, copies))
+                    return;
+
+                if (i < len_subgraphs) {
+                    stack.push_back({s.child(node, i), 0});
+                } else {
+                    path.pop_back();
+                }
+            }
+        }
+    }
+
+    static Paths possible_deiterations(const Storage& s, ConstNode root) {
+        // an element with several originals on the sheet of assertion is
+        // listed once for each of them
+        Paths road;
+        visit_deiterations(s, root, [&](const std::vector<int>& path,
+            int copies) {
+            road.insert(road.end(), copies, path);
+            return true;
+        });
+        return road;
+    }
+
+    static void insert_subgraph(Storage& s, Node area, Entry&& entry) {
+        // binary search among the (sorted) siblings by representation
+        ConstNode node = s.entry_node(entry);
+        int low = 0, high = s.num_subgraphs(area);
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (compare(s, node, s.child(area, middle)) < 0)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        s.put_subgraph(area, low, std::move(entry));
+    }
+
+    static void insert_atom(Storage& s, Node area, AtomEntry&& entry) {
+        const auto& atoms = s.atoms(area);
+        int index = std::upper_bound(atoms.begin(), atoms.end(),
+            s.entry_atom(entry), Atoms::less) - atoms.begin();
+        s.put_atom(area, index, std::move(entry));
+    }
+
+    static int reposition(Storage& s, Node parent, int index) {
+        // restores the canonical order after the subgraph at <index>
+        // changed while every other sibling stayed sorted; returns its new
+        // index
+        int len_subgraphs = s.num_subgraphs(parent);
+        if (len_subgraphs == 1)
+            return index;
+
+        // the changed child is compared without building its label, which
+        // stays dropped until something asks for it
+        ConstNode node = s.child(parent, index);
+        int low = index, high = index;
+        if (index > 0 && compare(s, node, s.child(parent, index - 1)) < 0) {
+            low = 0;
+            while (low < high) {
+                int middle = (low + high) / 2;
+                if (compare(s, node, s.child(parent, middle)) < 0)
+                    high = middle;
+                else
+                    low = middle + 1;
+            }
+        } else if (index + 1 < len_subgraphs &&
+            compare(s, s.child(parent, index + 1), node) < 0) {
+            low = index + 1;
+            high = len_subgraphs;
+            while (low < high) {
+                int middle = (low + high) / 2;
+                if (compare(s, s.child(parent, middle), node) < 0)
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+            low--;
+        }
+        s.move_subgraph(parent, index, low);
+        return low;
+    }
+
+    template <class Change>
+    static void edit(Storage& s, Node root, const std::vector<int>& where,
+        Change change) {
+        // calls change(area, index) on the area that holds the element at
+        // <where>, then fixes what the ancestors cache and their canonical
+        // order, from the bottom up
+        std::vector<Node> nodes = {root};
+        std::vector<Summary> old;
+        for (size_t k = 0; k + 1 < where.size(); k++) {
+            Node child = s.child(nodes.back(), where[k]);
+            old.push_back(s.summary(child));
+            nodes.push_back(child);
+        }
+
+        change(nodes.back(), where.back());
+
+        for (size_t k = nodes.size() - 1; k > 0; k--) {
+            s.update(nodes[k - 1], old[k - 1], nodes[k]);
+            // the child changed, so only its position among siblings may
+            // be stale
+            reposition(s, nodes[k - 1], where[k - 1]);
+        }
+    }
+
+    static void double_cut(Storage& s, Node root,
+        const std::vector<int>& where) {
+        edit(s, root, where, [&s](Node area, int index) {
+            Entry cut = s.take_subgraph(area, index);
+            Node inner = s.child(s.entry_node(cut), 0);
+            std::vector<Entry> subgraphs = s.take_subgraphs(inner);
+            std::vector<AtomEntry> atoms = s.take_atoms(inner);
+            s.drop(std::move(cut));
+
+            for (auto& sg : subgraphs)
+                insert_subgraph(s, area, std::move(sg));
+            for (auto& atom : atoms)
+                insert_atom(s, area, std::move(atom));
+        });
+    }
+
+    static void erase(Storage& s, Node root, const std::vector<int>& where) {
+        edit(s, root, where, [&s](Node area, int index) {
+            int len_subgraphs = s.num_subgraphs(area);
+            if (index < len_subgraphs)
+                s.drop(s.take_subgraph(area, index));
+            else
+                s.remove_atom(area, index - len_subgraphs);
+        });
+    }
+
+    static void deiterate(Storage& s, Node root,
+        const std::vector<int>& where) {
+        // the copy is removed just like an erased element
+        erase(s, root, where);
+    }
+};
+
+// a graph that owns its storage, for the storages that are not AEGraph
+template <class Storage>
+class GraphEngine {
+ public:
+    using Algorithms = GraphAlgorithms<Storage>;
+    using Atoms = typename Storage::Atoms;
+    using Paths = typename Algorithms::Paths;
+
+    explicit GraphEngine(const std::string& representation)
+        : storage(AEGraph(representation)) {}
+    explicit GraphEngine(const AEGraph& graph) : storage(graph) {}
+
+    std::string repr() const {
+        return Algorithms::repr(storage, storage.root());
+    }
+    AEGraph to_graph() const { return AEGraph(repr()); }
+
+    bool contains(const std::string& other) const {
+        return Algorithms::contains(storage, storage.root(),
+            Atoms::make(other));
+    }
+    bool contains(const GraphEngine& other) const {
+        return Algorithms::contains(storage, storage.root(), other.storage,
+            other.storage.root());
+    }
+    Paths get_paths_to(const std::string& other) const {
+        return Algorithms::get_paths_to(storage, storage.root(),
+            Atoms::make(other));
+    }
+    Paths get_paths_to(const GraphEngine& other) const {
+        return Algorithms::get_paths_to(storage, storage.root(),
+            other.storage, other.storage.root());
+    }
+
+    Paths possible_double_cuts() const {
+        return Algorithms::possible_double_cuts(storage, storage.root());
+    }
+    Paths possible_erasures(int level = -1) const {
+        return Algorithms::possible_erasures(storage, storage.root(), level);
+    }
+    Paths possible_deiterations() const {
+        return Algorithms::possible_deiterations(storage, storage.root());
+    }
+
+    GraphEngine double_cut(const std::vector<int>& where) const {
+        GraphEngine result = *this;
+        Algorithms::double_cut(result.storage, result.storage.root(), where);
+        return result;
+    }
+    GraphEngine erase(const std::vector<int>& where) const {
+        GraphEngine result = *this;
+        Algorithms::erase(result.storage, result.storage.root(), where);
+        return result;
+    }
+    GraphEngine deiterate(const std::vector<int>& where) const {
+        GraphEngine result = *this;
+        Algorithms::deiterate(result.storage, result.storage.root(), where);
+        return result;
+    }
+
+ private:
+    Storage storage;
+};
+
+#endif  // AEGRAPH_ENGINE_H_
@@ -0,0 +1,282 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef AEGRAPH_LITERAL_H_
+#define AEGRAPH_LITERAL_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+#include "./aegraph.h"
+
+// A graph literal that is parsed, checked and put in canonical order by the
+// compiler: "([B], [A])"_aeg is a StaticGraph whose tables hold the cuts
+// and atoms already sorted the way AEGraph sorts them, so turning it into
+// an AEGraph parses and sorts nothing. A malformed literal does not compile
+// (the throw that rejects it cannot be evaluated at compile time).
+template <size_t N>
+struct StaticGraph {
+    // a literal of N characters, counting the final '\0', has fewer than N
+    // cuts and atoms; its canonical text adds at most a space per comma
+    char source[N];
+    int num_nodes;
+    int total_atoms;
+    bool is_SA[N];
+
+    // the subgraphs of cut v are subgraphs[first_subgraph[v]] onwards, in
+    // canonical order (cut 0 is the outermost one, and every cut comes
+    // after the cut that holds it); the atoms of cut v are slices
+    // [atom_begin[k], atom_begin[k] + atom_length[k]) of <source>, for k
+    // from first_atom[v] on, sorted by name
+    int first_subgraph[N];
+    int num_subgraphs[N];
+    int subgraphs[N];
+    int first_atom[N];
+    int num_atoms[N];
+    int atom_begin[N];
+    int atom_length[N];
+
+    char text[2 * N];
+    int length;
+
+    constexpr explicit StaticGraph(const char (&literal)[N])
+        : source(), num_nodes(1), total_atoms(0), is_SA(),
+          first_subgraph(), num_subgraphs(), subgraphs(), first_atom(),
+          num_atoms(), atom_begin(), atom_length(), text(), length(0) {
+        int len = N - 1;
+        require(len >= 2 && literal[len] == '\0', "empty graph literal");
+        require((literal[0] == '(' && literal[len - 1] == ')') ||
+            (literal[0] == '[' && literal[len - 1] == ']'),
+            "graph literal not enclosed in () or []");
+        for (int i = 0; i < len; i++) {
+            source[i] = literal[i];
+        }
+        is_SA[0] = literal[0] == '(';
+
+        // the elements in the order they are written, with their cut
+        int parent[N] = {};
+        int owner[N] = {};
+        int begin[N] = {};
+        int size[N] = {};
+
+        // the cuts whose ']' has not been read yet
+        int open[N] = {};
+        int depth = 0;
+        // start of the current element and whether it is a closed cut
+        int piece = 1;
+        bool closed = false;
+
+        for (int i = 1; i < len; i++) {
+            char c = literal[i];
+            if (c != '[' && c != ']' && c != ',' && i != len - 1)
+                continue;
+
+            int first = piece, last = i;
+            while (first < last && blank(literal[first]))
+                first++;
+            while (last > first && blank(literal[last - 1]))
+                last--;
+
+            if (c == '[' && i != len - 1) {
+                require(!closed && first == last, "'[' after an element");
+                parent[num_nodes] = depth ? open[depth - 1] : 0;
+                is_SA[num_nodes] = false;
+                open[depth++] = num_nodes++;
+                piece = i + 1;
+                continue;
+            }
+
+            // the current element ends here; an atom is added to its cut
+            require(!closed || first == last, "atom after a cut");
+            if (!closed && first < last) {
+                owner[total_atoms] = depth ? open[depth - 1] : 0;
+                begin[total_atoms] = first;
+                size[total_atoms] = last - first;
+                total_atoms++;
+            }
+            closed = false;
+            piece = i + 1;
+
+            if (c == ']' && i != len - 1) {
+                require(depth > 0, "unmatched ']'");
+                depth--;
+                closed = true;
+            }
+        }
+        require(depth == 0, "unmatched '['");
+
+        // group the subgraphs and the atoms by their cut
+        for (int v = 1; v < num_nodes; v++) {
+            num_subgraphs[parent[v]]++;
+        }
+        for (int k = 0; k < total_atoms; k++) {
+            num_atoms[owner[k]]++;
+        }
+        for (int v = 1; v < num_nodes; v++) {
+            first_subgraph[v] = first_subgraph[v - 1] + num_subgraphs[v - 1];
+            first_atom[v] = first_atom[v - 1] + num_atoms[v - 1];
+        }
+        int placed[N] = {};
+        for (int v = 1; v < num_nodes; v++) {
+            subgraphs[first_subgraph[parent[v]] + placed[parent[v]]++] = v;
+        }
+        int placed_atoms[N] = {};
+        for (int k = 0; k < total_atoms; k++) {
+            int slot = first_atom[owner[k]] + placed_atoms[owner[k]]++;
+            atom_begin[slot] = begin[k];
+            atom_length[slot] = size[k];
+        }
+
+        // insertion sort, which is stable like the sort of AEGraph
+        for (int v = 0; v < num_nodes; v++) {
+            for (int k = first_atom[v] + 1; k < first_atom[v] + num_atoms[v];
+                 k++) {
+                for (int j = k; j > first_atom[v] && less_atom(j, j - 1);
+                     j--) {
+                    swap(atom_begin[j], atom_begin[j - 1]);
+                    swap(atom_length[j], atom_length[j - 1]);
+                }
+            }
+        }
+
+        // a cut is sorted after all the cuts inside it, which come later
+        for (int v = num_nodes - 1; v >= 0; v--) {
+            int first = first_subgraph[v];
+            for (int k = first + 1; k < first + num_subgraphs[v]; k++) {
+                for (int j = k; j > first &&
+                     less_node(subgraphs[j], subgraphs[j - 1]); j--) {
+                    swap(subgraphs[j], subgraphs[j - 1]);
+                }
+            }
+        }
+
+        length = write(0, text);
+    }
+
+    std::string repr() const {
+        return std::string(text, length);
+    }
+
+    AEGraph graph() const {
+        // builds the AEGraph straight from the tables; they are already in
+        // canonical order, so nothing is parsed and only the cached sums are
+        // computed. The cuts are built from the last one, so every subgraph
+        // is ready before the cut that holds it (built[num_nodes - 1 - v] is
+        // cut v).
+        std::vector<AEGraph> built;
+        for (int v = num_nodes - 1; v >= 0; v--) {
+            AEGraph node;
+            node.is_SA = is_SA[v];
+            node.id = AEGraph::new_id();
+            for (int k = first_atom[v]; k < first_atom[v] + num_atoms[v];
+                 k++) {
+                node.atoms.push_back(
+                    std::string(source + atom_begin[k], atom_length[k]));
+                node.atom_ids.push_back(AEGraph::new_id());
+            }
+            for (int k = first_subgraph[v];
+                 k < first_subgraph[v] + num_subgraphs[v]; k++) {
+                node.subgraphs.push_back(
+                    std::move(built[num_nodes - 1 - subgraphs[k]]));
+            }
+            node.refresh();
+            built.push_back(std::move(node));
+        }
+        return std::move(built.back());
+    }
+
+ private:
+    static constexpr void require(bool ok, const char *what) {
+        if (!ok)
+            throw std::invalid_argument(what);
+    }
+
+    static constexpr bool blank(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static constexpr void swap(int &a, int &b) {
+        int c = a;
+        a = b;
+        b = c;
+    }
+
+    static constexpr bool less_text(const char *a, int len_a, const char *b,
+        int len_b) {
+        // the order of std::string
+        for (int i = 0; i < len_a && i < len_b; i++) {
+            if (a[i] != b[i])
+                return static_cast<unsigned char>(a[i]) <
+                    static_cast<unsigned char>(b[i]);
+        }
+        return len_a < len_b;
+    }
+
+    constexpr bool less_atom(int j, int k) const {
+        return less_text(source + atom_begin[j], atom_length[j],
+            source + atom_begin[k], atom_length[k]);
+    }
+
+    constexpr bool less_node(int a, int b) const {
+        // compares the canonical texts, like AEGraph::operator<
+        char text_a[2 * N] = {};
+        char text_b[2 * N] = {};
+        int len_a = write(a, text_a);
+        int len_b = write(b, text_b);
+        return less_text(text_a, len_a, text_b, len_b);
+    }
+
+    constexpr int write(int root, char *out) const {
+        // writes the text of cut <root>, whose cuts are already sorted, the
+        // way AEGraph::repr() does; returns its length
+        int stack[N] = {};
+        int next[N] = {};
+        int depth = 1, len = 0;
+        stack[0] = root;
+        out[len++] = is_SA[root] ? '(' : '[';
+
+        while (depth > 0) {
+            int v = stack[depth - 1];
+            int i = next[depth - 1]++;
+
+            if (i < num_subgraphs[v]) {
+                if (i > 0) {
+                    out[len++] = ',';
+                    out[len++] = ' ';
+                }
+                int sg = subgraphs[first_subgraph[v] + i];
+                out[len++] = is_SA[sg] ? '(' : '[';
+                stack[depth] = sg;
+                next[depth] = 0;
+                depth++;
+                continue;
+            }
+
+            for (int j = 0; j < num_atoms[v]; j++) {
+                if (i > 0 || j > 0) {
+                    out[len++] = ',';
+                    out[len++] = ' ';
+                }
+                int k = first_atom[v] + j;
+                for (int c = 0; c < atom_length[k]; c++) {
+                    out[len++] = source[atom_begin[k] + c];
+                }
+            }
+            out[len++] = is_SA[v] ? ')' : ']';
+            depth--;
+        }
+        return len;
+    }
+};
+
+// "([A], [B])"_aeg; the graph is built in a constant expression even where
+// the literal is used at run time, so a malformed one is always rejected
+// by the compiler (string literal operator templates are a GNU extension,
+// supported by gcc and clang)
+template <class Char, Char... chars>
+constexpr StaticGraph<sizeof...(chars) + 1> operator"" _aeg() {
+    constexpr StaticGraph<sizeof...(chars) + 1> graph({chars..., '\0'});
+    return graph;
+}
+
+#endif  // AEGRAPH_LITERAL_H_
@@ -0,0 +1,903 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <cassert>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include "./beta_graph.h"
+
+BetaGraph::BetaGraph(std::string representation) : g("()") {
+    // a single pass like the AEGraph parser, which splits atoms at commas
+    // and so cannot read argument lists; a line is made for every name
+    int len = representation.size();
+    assert(len >= 2 && representation[0] == '(' &&
+        representation[len - 1] == ')');
+
+    std::map<std::string, int> names;
+    std::vector<AEGraph> open;
+    std::string atom;
+    bool closed = false;
+    bool in_arguments = false;
+
+    auto finish_element = [&](AEGraph &area) {
+        std::string text = strip(atom);
+        assert(!closed || text.empty());
+        atom.clear();
+        closed = false;
+        if (text.empty())
+            return;
+
+        std::vector<std::string> arguments;
+        size_t open_paren = text.find('(');
+        if (open_paren != std::string::npos) {
+            assert(text.back() == ')');
+            std::string list = text.substr(open_paren + 1,
+                text.size() - open_paren - 2);
+            text = strip(text.substr(0, open_paren));
+            size_t begin = 0;
+            while (!strip(list).empty()) {
+                size_t comma = list.find(',', begin);
+                arguments.push_back(strip(list.substr(begin, comma - begin)));
+                assert(!arguments.back().empty());
+                if (comma == std::string::npos)
+                    break;
+                begin = comma + 1;
+            }
+        }
+        assert(!text.empty());
+
+        uint64_t atom_id = AEGraph::new_id();
+        area.atoms.push_back(text);
+        area.atom_ids.push_back(atom_id);
+        hooks[atom_id] = {static_cast<int>(hook_element.size()),
+            static_cast<int>(arguments.size())};
+        for (const auto& name : arguments) {
+            if (!names.count(name))
+                names[name] = new_element();
+            hook_element.push_back(names[name]);
+            hook_atom.push_back(atom_id);
+        }
+    };
+
+    for (int i = 1; i < len - 1; i++) {
+        char c = representation[i];
+        if (in_arguments) {
+            assert(c != '[' && c != ']' && c != '(');
+            atom += c;
+            in_arguments = c != ')';
+        } else if (c == '(') {
+            atom += c;
+            in_arguments = true;
+        } else if (c == '[') {
+            assert(!closed && strip(atom).empty());
+            open.push_back(AEGraph("[]"));
+        } else if (c == ',') {
+            finish_element(open.empty() ? g : open.back());
+        } else if (c == ']') {
+            assert(!open.empty());
+            finish_element(open.back());
+            AEGraph cut = std::move(open.back());
+            open.pop_back();
+            (open.empty() ? g : open.back()).subgraphs.push_back(
+                std::move(cut));
+            closed = true;
+        } else {
+            atom += c;
+        }
+    }
+    assert(open.empty() && !in_arguments);
+    finish_element(g);
+    g.sort();
+
+    // the areas, which the lines are then placed in
+    area_parent[g.id] = 0;
+    std::vector<const AEGraph*> stack = {&g};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back();
+        stack.pop_back();
+        for (uint64_t atom_id : node->atom_ids) {
+            atom_area[atom_id] = node->id;
+        }
+        for (const auto& sg : node->subgraphs) {
+            area_parent[sg.id] = node->id;
+            stack.push_back(&sg);
+        }
+    }
+    for (size_t h = 0; h < hook_element.size(); h++) {
+        add_hook(h);
+    }
+}
+
+const AEGraph& BetaGraph::graph() const {
+    return g;
+}
+
+int BetaGraph::new_element() {
+    parent.push_back(parent.size());
+    rank.push_back(0);
+    return parent.size() - 1;
+}
+
+int BetaGraph::find(int element) const {
+    while (parent[element] != element) {
+        parent[element] = parent[parent[element]];
+        element = parent[element];
+    }
+    return element;
+}
+
+int BetaGraph::hook(const std::vector<int>& atom, int slot) const {
+    auto it = hooks.find(g.node_id(atom));
+    assert(it != hooks.end() && slot >= 0 && slot < it->second.arity);
+    return it->second.first + slot;
+}
+
+int BetaGraph::arity(const std::vector<int>& atom) const {
+    auto it = hooks.find(g.node_id(atom));
+    assert(it != hooks.end());
+    return it->second.arity;
+}
+
+int BetaGraph::num_lines() const {
+    return lines.size();
+}
+
+bool BetaGraph::same_line(const std::vector<int>& atom, int slot,
+    const std::vector<int>& other, int other_slot) const {
+    return find(hook_element[hook(atom, slot)]) ==
+        find(hook_element[hook(other, other_slot)]);
+}
+
+std::vector<uint64_t> BetaGraph::atoms_in(const std::vector<int>& where)
+    const {
+    // the ids of the atoms in the element at <where>
+    const AEGraph *node = &g;
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        node = &node->subgraphs[where[k]];
+    }
+    int index = where.back();
+    if (index >= node->num_subgraphs())
+        return {node->atom_ids[index - node->num_subgraphs()]};
+
+    std::vector<uint64_t> ids;
+    std::vector<const AEGraph*> stack = {&node->subgraphs[index]};
+    while (!stack.empty()) {
+        const AEGraph *top = stack.back();
+        stack.pop_back();
+        ids.insert(ids.end(), top->atom_ids.begin(), top->atom_ids.end());
+        for (const auto& sg : top->subgraphs) {
+            stack.push_back(&sg);
+        }
+    }
+    return ids;
+}
+
+int BetaGraph::depth(uint64_t area) const {
+    // the number of cuts around <area>
+    int result = 0;
+    while ((area = area_parent.at(area)) != 0)
+        result++;
+    return result;
+}
+
+uint64_t BetaGraph::common_area(uint64_t area, uint64_t other) const {
+    // the innermost area that holds both
+    int area_depth = depth(area), other_depth = depth(other);
+    for (; area_depth > other_depth; area_depth--)
+        area = area_parent.at(area);
+    for (; other_depth > area_depth; other_depth--)
+        other = area_parent.at(other);
+    while (area != other) {
+        area = area_parent.at(area);
+        other = area_parent.at(other);
+    }
+    return area;
+}
+
+uint64_t BetaGraph::branch(uint64_t area, uint64_t scope) const {
+    // the branch of <scope> that holds <area>, which lies inside it
+    if (area == scope)
+        return scope;
+    while (area_parent.at(area) != scope)
+        area = area_parent.at(area);
+    return area;
+}
+
+void BetaGraph::widen(Line *line, uint64_t scope) const {
+    // moves the outermost area of a line out to <scope>, which holds it;
+    // all of its hooks are then in a single branch
+    if (line->scope == scope)
+        return;
+    line->branches = {{branch(line->scope, scope), line->size}};
+    line->scope = scope;
+}
+
+void BetaGraph::add_hook(int h) {
+    int root = find(hook_element[h]);
+    uint64_t area = atom_area.at(hook_atom[h]);
+    auto it = lines.find(root);
+    if (it == lines.end()) {
+        lines[root] = {area, 1, {{area, 1}}};
+        return;
+    }
+
+    Line &line = it->second;
+    widen(&line, common_area(line.scope, area));
+    line.branches[branch(area, line.scope)]++;
+    line.size++;
+}
+
+std::vector<int> BetaGraph::take_hooks(const std::vector<int>& taken) {
+    // takes the hooks off their lines while their atoms are still in the
+    // graph; returns the lines they leave, which may have to be rescoped
+    std::vector<int> roots;
+    for (int h : taken) {
+        int root = find(hook_element[h]);
+        Line &line = lines.at(root);
+        auto it = line.branches.find(
+            branch(atom_area.at(hook_atom[h]), line.scope));
+        if (--it->second == 0)
+            line.branches.erase(it);
+        if (--line.size == 0)
+            lines.erase(root);
+        else
+            roots.push_back(root);
+    }
+    return roots;
+}
+
+void BetaGraph::rescope(const std::vector<int>& roots) {
+    // a line that no longer reaches its outermost area is placed again
+    // from all of its hooks; the checks of the rules never let this
+    // happen, so only the unchecked changes pay for the scan
+    std::set<int> stale;
+    for (int root : roots) {
+        auto it = lines.find(root);
+        if (it != lines.end() && it->second.branches.size() < 2 &&
+            !it->second.branches.count(it->second.scope))
+            stale.insert(root);
+    }
+    if (stale.empty())
+        return;
+
+    for (int root : stale) {
+        lines.erase(root);
+    }
+    for (const auto& entry : hooks) {
+        for (int k = 0; k < entry.second.arity; k++) {
+            int h = entry.second.first + k;
+            if (stale.count(find(hook_element[h])))
+                add_hook(h);
+        }
+    }
+}
+
+bool BetaGraph::keeps_scopes(const std::vector<uint64_t>& skip_atoms,
+    int skip_hook) const {
+    // whether every line that is left still reaches its outermost area:
+    // it keeps hooks on the area's own atoms, or in two of its branches
+    std::vector<int> taken;
+    for (uint64_t atom_id : skip_atoms) {
+        const Hooks &atom_hooks = hooks.at(atom_id);
+        for (int k = 0; k < atom_hooks.arity; k++) {
+            taken.push_back(atom_hooks.first + k);
+        }
+    }
+    if (skip_hook >= 0)
+        taken.push_back(skip_hook);
+
+    // the hooks taken from every branch of every line
+    std::map<int, std::unordered_map<uint64_t, int>> removed;
+    for (int h : taken) {
+        int root = find(hook_element[h]);
+        const Line &line = lines.at(root);
+        removed[root][branch(atom_area.at(hook_atom[h]), line.scope)]++;
+    }
+
+    for (const auto& entry : removed) {
+        const Line &line = lines.at(entry.first);
+        int left = line.size;
+        int emptied = 0;
+        bool own = line.branches.count(line.scope);
+        for (const auto& taken_from : entry.second) {
+            left -= taken_from.second;
+            if (taken_from.second == line.branches.at(taken_from.first)) {
+                emptied++;
+                own = own && taken_from.first != line.scope;
+            }
+        }
+        int branches_left = line.branches.size() - emptied;
+        if (left > 0 && !own && branches_left < 2)
+            return false;
+    }
+    return true;
+}
+
+void BetaGraph::drop_element(const std::vector<int>& where) {
+    // the hooks of the dropped atoms are left in the union-find, where they
+    // still connect the others
+    std::vector<uint64_t> atom_ids = atoms_in(where);
+    std::vector<int> taken;
+    for (uint64_t atom_id : atom_ids) {
+        const Hooks &atom_hooks = hooks.at(atom_id);
+        for (int k = 0; k < atom_hooks.arity; k++) {
+            taken.push_back(atom_hooks.first + k);
+        }
+    }
+    std::vector<int> roots = take_hooks(taken);
+    for (uint64_t atom_id : atom_ids) {
+        hooks.erase(atom_id);
+        atom_area.erase(atom_id);
+    }
+
+    const AEGraph *area = &g;
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        area = &area->subgraphs[where[k]];
+    }
+    std::vector<const AEGraph*> stack;
+    if (where.back() < area->num_subgraphs())
+        stack.push_back(&area->subgraphs[where.back()]);
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back();
+        stack.pop_back();
+        area_parent.erase(node->id);
+        for (const auto& sg : node->subgraphs) {
+            stack.push_back(&sg);
+        }
+    }
+    rescope(roots);
+}
+
+AEGraph BetaGraph::labelled(const std::map<int, int>& names) const {
+    // every atom becomes "P(x1, x2)", with the names of its lines ("_" for
+    // a line without one); the ids are kept, so paths can be mapped back
+    AEGraph result = g;
+    std::vector<AEGraph*> stack = {&result};
+    while (!stack.empty()) {
+        AEGraph *node = stack.back();
+        stack.pop_back();
+
+        for (int j = 0; j < node->num_atoms(); j++) {
+            const Hooks &atom_hooks = hooks.at(node->atom_ids[j]);
+            if (atom_hooks.arity == 0)
+                continue;
+            std::string text = node->atoms[j] + "(";
+            for (int k = 0; k < atom_hooks.arity; k++) {
+                int root = find(hook_element[atom_hooks.first + k]);
+                auto it = names.find(root);
+                text += k ? ", " : "";
+                text += it == names.end() ? "_" :
+                    "x" + std::to_string(it->second);
+            }
+            node->atoms[j] = text + ")";
+        }
+        for (auto& sg : node->subgraphs) {
+            stack.push_back(&sg);
+        }
+    }
+    result.sort();
+    return result;
+}
+
+std::map<int, int> BetaGraph::first_appearance(const AEGraph& graph) const {
+    // numbers the lines from 1 in the order they appear in the text of
+    // <graph>, where the atoms of a cut come after its subgraphs
+    std::map<int, int> names;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&graph, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        if (i < node->num_subgraphs()) {
+            stack.push_back({&node->subgraphs[i], 0});
+            continue;
+        }
+
+        for (uint64_t atom_id : node->atom_ids) {
+            const Hooks &atom_hooks = hooks.at(atom_id);
+            for (int k = 0; k < atom_hooks.arity; k++) {
+                int root = find(hook_element[atom_hooks.first + k]);
+                if (!names.count(root)) {
+                    int number = names.size() + 1;
+                    names[root] = number;
+                }
+            }
+        }
+        stack.pop_back();
+    }
+    return names;
+}
+
+void BetaGraph::refine(std::map<int, int> *colors) const {
+    // splits the classes of lines (numbered from 0, in order) by where
+    // their hooks are in the graph labelled with the classes, until no
+    // class splits; a class only splits, so this ends
+    int classes = 0;
+    for (const auto& line : *colors) {
+        classes = std::max(classes, line.second + 1);
+    }
+
+    while (true) {
+        AEGraph graph = numbered(*colors);
+
+        // a hook is described by its slot, the text of its atom and the
+        // hashes of the cuts around it
+        std::map<int, std::vector<uint64_t>> hooks_of;
+        std::vector<std::pair<const AEGraph*, uint64_t>> stack = {
+            {&graph, mix64(graph.hash())}};
+        while (!stack.empty()) {
+            const AEGraph *node = stack.back().first;
+            uint64_t around = stack.back().second;
+            stack.pop_back();
+
+            for (int j = 0; j < node->num_atoms(); j++) {
+                const Hooks &atom_hooks = hooks.at(node->atom_ids[j]);
+                uint64_t atom = atom_hash(node->atoms[j]);
+                for (int k = 0; k < atom_hooks.arity; k++) {
+                    int root = find(hook_element[atom_hooks.first + k]);
+                    hooks_of[root].push_back(
+                        mix64(around ^ mix64(atom + k + 1)));
+                }
+            }
+            for (const auto& sg : node->subgraphs) {
+                stack.push_back({&sg, mix64(around + sg.hash())});
+            }
+        }
+
+        std::vector<std::pair<std::pair<int, std::vector<uint64_t>>, int>>
+            order;
+        for (const auto& line : *colors) {
+            auto &described = hooks_of[line.first];
+            std::sort(described.begin(), described.end());
+            order.push_back({{line.second, described}, line.first});
+        }
+        std::sort(order.begin(), order.end());
+
+        int split = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            if (i > 0 && order[i].first != order[i - 1].first)
+                split++;
+            (*colors)[order[i].second] = split;
+        }
+        if (split + 1 == classes || order.empty())
+            return;
+        classes = split + 1;
+    }
+}
+
+AEGraph BetaGraph::numbered(const std::map<int, int>& colors) const {
+    // the graph labelled with a class numbering of the lines
+    std::map<int, int> numbers;
+    for (const auto& line : colors) {
+        numbers[line.first] = line.second + 1;
+    }
+    return labelled(numbers);
+}
+
+std::string BetaGraph::repr() const {
+    // the numbering of the lines with the smallest text, among those that
+    // refining and then setting lines apart one at a time can give; the
+    // lines set apart and the class they are taken from only depend on the
+    // structure, so isomorphic graphs get the same text. Two numberings
+    // with the same text are an automorphism, which is used to skip
+    // choices that give what an earlier one gave (with an explicit stack
+    // of choices). The lines are then renamed in the order they appear.
+    std::map<int, int> colors;
+    for (const auto& line : lines) {
+        colors[line.first] = 0;
+    }
+    refine(&colors);
+
+    // a union-find over the lines of the class a choice is made from, by
+    // the automorphisms that fix the earlier choices, and the roots of the
+    // orbits with a line that was tried
+    struct Frame {
+        std::map<int, int> colors;
+        std::vector<int> cell;
+        size_t next;
+        std::map<int, int> orbit;
+        std::set<int> tried;
+        size_t automorphisms_seen;
+        size_t swaps_seen;
+    };
+    std::vector<Frame> stack;
+    std::vector<int> path;
+
+    std::string first, best;
+    std::vector<int> first_path;
+    std::map<int, int> first_lines, best_lines, best_colors;
+    std::vector<std::map<int, int>> automorphisms;
+    // transpositions of lines that are automorphisms
+    std::vector<std::pair<int, int>> swaps;
+    std::map<int, int> first_colors;
+    bool found = false;
+
+    while (true) {
+        // the first class with more than one line, if any
+        std::map<int, std::vector<int>> classes;
+        for (const auto& line : colors) {
+            classes[line.second].push_back(line.first);
+        }
+        std::vector<int> cell;
+        for (const auto& c : classes) {
+            if (c.second.size() > 1) {
+                cell = c.second;
+                break;
+            }
+        }
+
+        if (!cell.empty()) {
+            std::map<int, int> orbit;
+            for (int line : cell) {
+                orbit[line] = line;
+            }
+            stack.push_back({colors, cell, 0, orbit, {}, 0, 0});
+        } else {
+            std::string text = numbered(colors).repr();
+            std::map<int, int> lines_by_name;
+            for (const auto& line : colors) {
+                lines_by_name[line.second] = line.first;
+            }
+
+            if (!found) {
+                found = true;
+                first = best = text;
+                first_path = path;
+                first_lines = best_lines = lines_by_name;
+                first_colors = best_colors = colors;
+            } else if (text == first || text == best) {
+                std::map<int, int> &other = text == first ? first_lines
+                                                          : best_lines;
+                std::map<int, int> automorphism;
+                for (const auto& line : lines_by_name) {
+                    automorphism[other[line.first]] = line.second;
+                }
+                automorphisms.push_back(automorphism);
+
+                // the choices since the first path left it give an image
+                // of what was found below that point
+                if (text == first) {
+                    size_t common = 0;
+                    while (common + 1 < path.size() &&
+                           common < first_path.size() &&
+                           path[common] == first_path[common])
+                        common++;
+                    stack.resize(common + 1);
+                    path.resize(common + 1);
+                }
+            } else if (text < best) {
+                best = text;
+                best_lines = lines_by_name;
+                best_colors = colors;
+            }
+        }
+
+        // the next choice that no automorphism fixing the earlier ones
+        // maps to a choice already tried
+        bool chosen = false;
+        while (!chosen && !stack.empty()) {
+            Frame &top = stack.back();
+            path.resize(stack.size() - 1);
+            if (top.next == top.cell.size()) {
+                stack.pop_back();
+                continue;
+            }
+
+            auto find_orbit = [&top](int line) {
+                while (top.orbit[line] != line)
+                    line = top.orbit[line] = top.orbit[top.orbit[line]];
+                return line;
+            };
+            auto merge = [&](int line, int other) {
+                line = find_orbit(line);
+                other = find_orbit(other);
+                if (line == other)
+                    return;
+                top.orbit[other] = line;
+                if (top.tried.erase(other))
+                    top.tried.insert(line);
+            };
+
+            // the automorphisms found since the last choice here; one that
+            // fixes the earlier choices keeps the class, and so does a
+            // transposition of two of its lines
+            for (; top.automorphisms_seen < automorphisms.size();
+                 top.automorphisms_seen++) {
+                const auto &automorphism =
+                    automorphisms[top.automorphisms_seen];
+                bool fixes = true;
+                for (int chosen_line : path) {
+                    fixes = fixes &&
+                        automorphism.at(chosen_line) == chosen_line;
+                }
+                for (int member : top.cell) {
+                    if (fixes)
+                        merge(member, automorphism.at(member));
+                }
+            }
+            for (; top.swaps_seen < swaps.size(); top.swaps_seen++) {
+                const auto &swap = swaps[top.swaps_seen];
+                if (top.orbit.count(swap.first) && top.orbit.count(swap.second))
+                    merge(swap.first, swap.second);
+            }
+
+            int line = top.cell[top.next++];
+            if (top.tried.count(find_orbit(line)))
+                continue;
+
+            // a line that can trade places with the first one tried in the
+            // first numbering found is in its orbit; this is tested before
+            // going down, since it settles classes of interchangeable lines
+            // at one test per choice
+            if (top.next > 1) {
+                std::map<int, int> swapped = first_colors;
+                std::swap(swapped[top.cell[0]], swapped[line]);
+                if (numbered(swapped).repr() == first) {
+                    swaps.push_back({top.cell[0], line});
+                    continue;
+                }
+            }
+            top.tried.insert(find_orbit(line));
+
+            // <line> gets the number of its class, and the rest of the
+            // class the next one
+            colors = top.colors;
+            int own = colors[line];
+            for (auto& other : colors) {
+                if (other.second > own ||
+                    (other.second == own && other.first != line))
+                    other.second++;
+            }
+            refine(&colors);
+            path.push_back(line);
+            chosen = true;
+        }
+        if (!chosen)
+            break;
+    }
+    return labelled(first_appearance(numbered(best_colors))).repr();
+}
+
+std::vector<std::vector<int>> BetaGraph::possible_double_cuts() const {
+    // a line cannot have its outermost part between the two cuts, which
+    // hold nothing else, so lines only pass through them
+    return g.possible_double_cuts();
+}
+
+std::vector<std::vector<int>> BetaGraph::possible_erasures() const {
+    std::vector<std::vector<int>> sites;
+    for (auto& where : g.possible_erasures()) {
+        if (keeps_scopes(atoms_in(where)))
+            sites.push_back(where);
+    }
+    return sites;
+}
+
+bool BetaGraph::copies_atom(uint64_t copy, uint64_t original) const {
+    // every hook of the copy is on the line of the original's hook in the
+    // same slot, or on a line that has no hooks outside the copy; such a
+    // line says less than the original's, as long as the slots it joins
+    // are joined in the original too
+    const Hooks &copy_hooks = hooks.at(copy);
+    const Hooks &original_hooks = hooks.at(original);
+    if (copy_hooks.arity != original_hooks.arity)
+        return false;
+
+    std::map<int, int> local;
+    for (int k = 0; k < copy_hooks.arity; k++) {
+        int root = find(hook_element[copy_hooks.first + k]);
+        int original_root = find(hook_element[original_hooks.first + k]);
+        if (root == original_root)
+            continue;
+        auto it = local.find(root);
+        if (it == local.end()) {
+            int on_copy = 0;
+            for (int j = 0; j < copy_hooks.arity; j++) {
+                on_copy += find(hook_element[copy_hooks.first + j]) == root;
+            }
+            if (lines.at(root).size != on_copy)
+                return false;
+            local[root] = original_root;
+        } else if (it->second != original_root) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::vector<int>> BetaGraph::possible_deiterations() const {
+    // the subgraphs are matched in the labelled graph, where a copy must
+    // be on the same lines as its original, and mapped back to paths of
+    // the graph; the atoms are matched by copies_atom()
+    std::map<int, int> roots;
+    for (size_t element = 0; element < parent.size(); element++) {
+        roots[find(element)] = find(element);
+    }
+    AEGraph graph = labelled(roots);
+
+    std::vector<std::vector<int>> sites;
+    for (auto& site : graph.possible_deiterations()) {
+        std::vector<int> where;
+        g.find_node(graph.node_id(site), where);
+        const AEGraph *area = &g;
+        for (size_t k = 0; k + 1 < where.size(); k++) {
+            area = &area->subgraphs[where[k]];
+        }
+        if (where.back() < area->num_subgraphs() &&
+            keeps_scopes(atoms_in(where)))
+            sites.push_back(where);
+    }
+
+    // like AEGraph, a copy is an element of an area with other elements,
+    // inside a cut on the sheet, and its originals are on the sheet
+    std::vector<int> path;
+    std::vector<std::pair<const AEGraph*, int>> stack;
+    for (int j = 0; j < g.num_subgraphs(); j++) {
+        path.assign(1, j);
+        stack.assign(1, {&g.subgraphs[j], 0});
+        while (!stack.empty()) {
+            const AEGraph *node = stack.back().first;
+            int i = stack.back().second++;
+            if (i < node->num_subgraphs()) {
+                path.push_back(i);
+                stack.push_back({&node->subgraphs[i], 0});
+                continue;
+            }
+
+            for (int k = 0; node->size() > 1 && k < node->num_atoms(); k++) {
+                auto range = std::equal_range(g.atoms.begin(), g.atoms.end(),
+                    node->atoms[k]);
+                path.push_back(node->num_subgraphs() + k);
+                for (auto it = range.first; it != range.second; ++it) {
+                    uint64_t original = g.atom_ids[it - g.atoms.begin()];
+                    if (copies_atom(node->atom_ids[k], original) &&
+                        keeps_scopes({node->atom_ids[k]}))
+                        sites.push_back(path);
+                }
+                path.pop_back();
+            }
+            stack.pop_back();
+            path.pop_back();
+        }
+    }
+    std::sort(sites.begin(), sites.end());
+    return sites;
+}
+
+void BetaGraph::double_cut(const std::vector<int>& where) {
+    // the contents of the inner cut move out to the area of the outer one,
+    // so the lines that ran into the cuts from there get new branches, and
+    // those whose outermost area was the inner cut move out with them
+    const AEGraph *area = &g;
+    for (size_t k = 0; k + 1 < where.size(); k++) {
+        area = &area->subgraphs[where[k]];
+    }
+    const AEGraph &outer = area->subgraphs[where.back()];
+    const AEGraph &inner = outer.subgraphs[0];
+
+    std::set<int> moved;
+    // the nodes inside the inner cut, with their branch of <area> once
+    // they are moved
+    std::vector<std::pair<const AEGraph*, uint64_t>> stack = {
+        {&inner, area->id}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        uint64_t key = stack.back().second;
+        stack.pop_back();
+
+        for (uint64_t atom_id : node->atom_ids) {
+            const Hooks &atom_hooks = hooks.at(atom_id);
+            for (int k = 0; k < atom_hooks.arity; k++) {
+                int root = find(hook_element[atom_hooks.first + k]);
+                Line &line = lines.at(root);
+                if (line.scope == inner.id) {
+                    moved.insert(root);
+                } else if (line.scope == area->id) {
+                    if (--line.branches[outer.id] == 0)
+                        line.branches.erase(outer.id);
+                    line.branches[key]++;
+                }
+            }
+        }
+        for (const auto& sg : node->subgraphs) {
+            stack.push_back({&sg, node == &inner ? sg.id : key});
+        }
+    }
+
+    for (int root : moved) {
+        Line &line = lines.at(root);
+        auto it = line.branches.find(inner.id);
+        if (it != line.branches.end()) {
+            int own = it->second;
+            line.branches.erase(it);
+            line.branches[area->id] = own;
+        }
+        line.scope = area->id;
+    }
+    for (uint64_t atom_id : inner.atom_ids) {
+        atom_area[atom_id] = area->id;
+    }
+    for (const auto& sg : inner.subgraphs) {
+        area_parent[sg.id] = area->id;
+    }
+    area_parent.erase(outer.id);
+    area_parent.erase(inner.id);
+
+    g.double_cut_helper(where, g);
+}
+
+void BetaGraph::erase(const std::vector<int>& where) {
+    drop_element(where);
+    g.erase_helper(where, g);
+}
+
+void BetaGraph::deiterate(const std::vector<int>& where) {
+    drop_element(where);
+    g.deiterate_helper(where, g);
+}
+
+bool BetaGraph::can_join(const std::vector<int>& atom, int slot,
+    const std::vector<int>& other, int other_slot) const {
+    int root = find(hook_element[hook(atom, slot)]);
+    int other_root = find(hook_element[hook(other, other_slot)]);
+    if (root == other_root)
+        return false;
+
+    uint64_t scope = lines.at(root).scope;
+    uint64_t other_scope = lines.at(other_root).scope;
+    uint64_t outer = common_area(scope, other_scope);
+    if (outer != scope && outer != other_scope)
+        return false;
+    uint64_t inner = outer == scope ? other_scope : scope;
+    return depth(inner) % 2 == 1;
+}
+
+void BetaGraph::join(const std::vector<int>& atom, int slot,
+    const std::vector<int>& other, int other_slot) {
+    // union by rank
+    int root = find(hook_element[hook(atom, slot)]);
+    int other_root = find(hook_element[hook(other, other_slot)]);
+    if (root == other_root)
+        return;
+    Line line = std::move(lines.at(root));
+    Line other_line = std::move(lines.at(other_root));
+    lines.erase(root);
+    lines.erase(other_root);
+
+    if (rank[root] < rank[other_root])
+        std::swap(root, other_root);
+    parent[other_root] = root;
+    if (rank[root] == rank[other_root])
+        rank[root]++;
+
+    // the joined line reaches the outermost area of the two; the smaller
+    // set of branches is merged into the larger one
+    uint64_t scope = common_area(line.scope, other_line.scope);
+    widen(&line, scope);
+    widen(&other_line, scope);
+    if (line.branches.size() < other_line.branches.size())
+        std::swap(line, other_line);
+    for (const auto& entry : other_line.branches) {
+        line.branches[entry.first] += entry.second;
+    }
+    line.size += other_line.size;
+    lines[root] = std::move(line);
+}
+
+bool BetaGraph::can_sever(const std::vector<int>& atom, int slot) const {
+    // the area of the hook must be positive (inside an even number of
+    // cuts), and the rest of the line must still reach the same area
+    int h = hook(atom, slot);
+    return (atom.size() - 1) % 2 == 0 &&
+        lines.at(find(hook_element[h])).size > 1 && keeps_scopes({}, h);
+}
+
+void BetaGraph::sever(const std::vector<int>& atom, int slot) {
+    int h = hook(atom, slot);
+    std::vector<int> roots = take_hooks({h});
+    hook_element[h] = new_element();
+    rescope(roots);
+    add_hook(h);
+}
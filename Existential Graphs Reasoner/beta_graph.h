@@ -0,0 +1,125 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef BETA_GRAPH_H_
+#define BETA_GRAPH_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include "./aegraph.h"
+
+// A Beta graph: the cuts and atoms are an AEGraph whose atoms are predicate
+// names, and the argument slots of every atom (its hooks) are joined by
+// lines of identity. "([Man(x), [Mortal(x)]])" has one line, x, with a
+// hook on each atom; a name stands for a single line, whose outermost part
+// lies in the innermost area that holds all of its hooks.
+//
+// The lines are a union-find over hooks, so joining two lines and cutting
+// a hook off its line take near-constant time: a hook that is cut off is
+// moved to a new element, and the one it leaves behind stays in the
+// structure only to keep the other hooks connected. Every line keeps its
+// outermost area next to the union-find, so the checks below only look at
+// the hooks they take away.
+//
+// A line means "there is something" in its outermost area, so a rule that
+// takes hooks off lines is only allowed if every line it touches still
+// reaches the same area, or is gone altogether. Like RuleSiteIndex, the
+// rules change the graph in place; paths are those of graph(), which is
+// kept sorted.
+class BetaGraph {
+ public:
+    explicit BetaGraph(std::string representation);
+
+    // the canonical text, the same for isomorphic graphs; the lines are
+    // named x1, x2, ... in the order they first appear in the graph sorted
+    // with a canonical numbering of them
+    std::string repr() const;
+    const AEGraph& graph() const;
+
+    int arity(const std::vector<int>& atom) const;
+    int num_lines() const;
+    bool same_line(const std::vector<int>& atom, int slot,
+        const std::vector<int>& other, int other_slot) const;
+
+    // the Alpha rules; an element that is removed takes its hooks off
+    // their lines, and a deiterated copy must be on the same lines as its
+    // original, except that an atom may also be on lines of its own, as in
+    // "(P(x), [P(y), Q])"
+    std::vector<std::vector<int>> possible_double_cuts() const;
+    std::vector<std::vector<int>> possible_erasures() const;
+    std::vector<std::vector<int>> possible_deiterations() const;
+    void double_cut(const std::vector<int>& where);
+    void erase(const std::vector<int>& where);
+    void deiterate(const std::vector<int>& where);
+
+    // two lines can be joined where both of them reach: the outermost area
+    // of one must hold that of the other, which must be negative (a line
+    // may be extended inwards). A hook in a positive area can be cut off
+    // its line, which erases the end of the line.
+    bool can_join(const std::vector<int>& atom, int slot,
+        const std::vector<int>& other, int other_slot) const;
+    void join(const std::vector<int>& atom, int slot,
+        const std::vector<int>& other, int other_slot);
+    bool can_sever(const std::vector<int>& atom, int slot) const;
+    void sever(const std::vector<int>& atom, int slot);
+
+ private:
+    struct Hooks {
+        int first;
+        int arity;
+    };
+    // the outermost area of a line (the innermost area that holds all of
+    // its hooks), and how many of its hooks lie in each branch of that
+    // area: the area itself, for the hooks on its own atoms, or one of its
+    // subgraphs. The area stays the outermost one as long as there are
+    // hooks on its own atoms or in two of its subgraphs.
+    struct Line {
+        uint64_t scope;
+        int size;
+        std::unordered_map<uint64_t, int> branches;
+    };
+
+    int hook(const std::vector<int>& atom, int slot) const;
+    int find(int element) const;
+    int new_element();
+    std::vector<uint64_t> atoms_in(const std::vector<int>& where) const;
+
+    // the areas, by node id
+    int depth(uint64_t area) const;
+    uint64_t common_area(uint64_t area, uint64_t other) const;
+    uint64_t branch(uint64_t area, uint64_t scope) const;
+    // the lines, kept up to date as hooks come and go
+    void widen(Line *line, uint64_t scope) const;
+    void add_hook(int h);
+    std::vector<int> take_hooks(const std::vector<int>& taken);
+    void rescope(const std::vector<int>& roots);
+    // takes the element at <where> out of the lines and the areas, before
+    // it is removed from the graph
+    void drop_element(const std::vector<int>& where);
+    bool keeps_scopes(const std::vector<uint64_t>& skip_atoms,
+        int skip_hook = -1) const;
+    bool copies_atom(uint64_t copy, uint64_t original) const;
+    // a copy of the graph whose atoms carry their lines, sorted
+    AEGraph labelled(const std::map<int, int>& names) const;
+    // canonical numbering of the lines, for repr()
+    std::map<int, int> first_appearance(const AEGraph& graph) const;
+    void refine(std::map<int, int> *colors) const;
+    AEGraph numbered(const std::map<int, int>& colors) const;
+
+    AEGraph g;
+    // the hooks of every atom, by atom id: hook_element[first + slot]
+    std::unordered_map<uint64_t, Hooks> hooks;
+    std::vector<int> hook_element;
+    std::vector<uint64_t> hook_atom;
+    // the union-find, with path halving done by the const lookups
+    mutable std::vector<int> parent;
+    std::vector<int> rank;
+    // the line of every union-find root that still has hooks
+    std::unordered_map<int, Line> lines;
+    // the area that holds every cut (0 for the sheet) and every atom
+    std::unordered_map<uint64_t, uint64_t> area_parent;
+    std::unordered_map<uint64_t, uint64_t> atom_area;
+};
+
+#endif  // BETA_GRAPH_H_
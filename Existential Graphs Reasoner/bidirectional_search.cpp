@@ -0,0 +1,224 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include "./bidirectional_search.h"
+#include "./knowledge_base.h"
+
+// the graphs one side of the search reached
+struct SearchSide {
+    struct Node {
+        std::string repr;
+        // forward: the graph the step was applied to; backward: the graph
+        // the step gives, one rule closer to the conclusion
+        int parent;
+        RuleStep step;
+    };
+
+    // false if the graph was reached already
+    bool add(const AEGraph& graph, int parent, const RuleStep& step) {
+        if (find(graph) != -1)
+            return false;
+        by_hash[graph.hash()].push_back(nodes.size());
+        nodes.push_back({graph.repr(), parent, step});
+        next.push_back({graph, static_cast<int>(nodes.size()) - 1});
+        return true;
+    }
+
+    int find(const AEGraph& graph) const {
+        auto it = by_hash.find(graph.hash());
+        if (it == by_hash.end())
+            return -1;
+        std::string repr = graph.repr();
+        for (int node : it->second) {
+            if (nodes[node].repr == repr)
+                return node;
+        }
+        return -1;
+    }
+
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, std::vector<int>> by_hash;
+    // the graphs of the last level, waiting to be expanded
+    std::vector<std::pair<AEGraph, int>> next;
+};
+
+std::vector<std::pair<AEGraph, RuleStep>> backward_steps(
+    const AEGraph& graph, int limit) {
+    // the graphs that <graph> follows from by one step, each with that
+    // step; the new nodes get fresh ids, which find their paths once the
+    // graph is sorted
+    std::vector<std::pair<AEGraph, RuleStep>> result;
+    auto add = [&](AEGraph next, uint64_t id, const std::string& rule) {
+        next.sort();
+        std::vector<int> where;
+        bool found = next.find_node(id, where);
+        if (found && (rule == "DC" ? next.can_double_cut(where) :
+                      next.can_deiterate(where))) {
+            result.push_back({std::move(next), {rule, where}});
+        }
+    };
+
+    // the cuts and the sheet, by path
+    std::vector<std::vector<int>> areas = {{}};
+    for (size_t k = 0; k < areas.size(); k++) {
+        const AEGraph *node = &graph;
+        for (int i : areas[k])
+            node = &node->subgraphs[i];
+        for (int i = 0; i < node->num_subgraphs(); i++) {
+            areas.push_back(areas[k]);
+            areas.back().push_back(i);
+        }
+    }
+    auto area = [](AEGraph &root, const std::vector<int>& path) {
+        AEGraph *node = &root;
+        for (int i : path)
+            node = &node->subgraphs[i];
+        return node;
+    };
+
+    // iterations of the distinct elements of the sheet into the cuts that
+    // are not empty
+    for (int e = 0; e < graph.size(); e++) {
+        bool is_cut = e < graph.num_subgraphs();
+        if (e > 0 && (is_cut ? graph.subgraphs[e] == graph.subgraphs[e - 1] :
+                      e > graph.num_subgraphs() &&
+                      graph.atoms[e - graph.num_subgraphs()] ==
+                      graph.atoms[e - graph.num_subgraphs() - 1]))
+            continue;
+        int added = is_cut ? graph.subgraphs[e].contribution().nodes : 1;
+        if (graph.total_size() + added > limit)
+            continue;
+
+        for (size_t k = 1; k < areas.size(); k++) {
+            AEGraph next = graph;
+            AEGraph *node = area(next, areas[k]);
+            if (node->size() == 0)
+                continue;
+            uint64_t id;
+            if (is_cut) {
+                AEGraph copy = graph.subgraphs[e];
+                copy.renumber();
+                id = copy.id;
+                node->subgraphs.push_back(std::move(copy));
+            } else {
+                id = AEGraph::new_id();
+                node->atoms.push_back(graph.atoms[e - graph.num_subgraphs()]);
+                node->atom_ids.push_back(id);
+            }
+            add(std::move(next), id, "DE");
+        }
+    }
+
+    // double cuts around one element or around all the elements of an area
+    if (graph.total_size() + 2 > limit)
+        return result;
+    for (const auto& path : areas) {
+        const AEGraph *original = &graph;
+        for (int i : path)
+            original = &original->subgraphs[i];
+        int n = original->size();
+        for (int e = 0; e <= n; e++) {
+            if (e == n && n < 2)
+                break;
+            AEGraph next = graph;
+            AEGraph *node = area(next, path);
+            AEGraph outer("[]"), inner("[]");
+            if (e == n) {
+                inner.subgraphs = std::move(node->subgraphs);
+                inner.atoms = std::move(node->atoms);
+                inner.atom_ids = std::move(node->atom_ids);
+                node->subgraphs.clear();
+                node->atoms.clear();
+                node->atom_ids.clear();
+            } else if (e < node->num_subgraphs()) {
+                inner.subgraphs.push_back(node->take_subgraph(e));
+            } else {
+                int j = e - node->num_subgraphs();
+                inner.atoms.push_back(node->atoms[j]);
+                inner.atom_ids.push_back(node->atom_ids[j]);
+                node->atoms.erase(node->atoms.begin() + j);
+                node->atom_ids.erase(node->atom_ids.begin() + j);
+            }
+            uint64_t id = outer.id;
+            outer.subgraphs.push_back(std::move(inner));
+            node->subgraphs.push_back(std::move(outer));
+            add(std::move(next), id, "DC");
+        }
+    }
+    return result;
+}
+
+ForwardProof forward_proof(const AEGraph& premise, const AEGraph& conclusion,
+    bool bidirectional, int limit) {
+    ForwardProof proof = {false, {}, 0, 0};
+    AEGraph start = premise, goal = conclusion;
+    start.sort();
+    goal.sort();
+
+    SearchSide forward, backward;
+    forward.add(start, -1, {});
+    backward.add(goal, -1, {});
+    if (!bidirectional)
+        backward.next.clear();
+
+    // the nodes where the two sides meet
+    int meet_forward = forward.find(goal), meet_backward = 0;
+    int max_size = start.total_size();
+
+    while (meet_forward == -1 && (!forward.next.empty() ||
+           !backward.next.empty()) &&
+           static_cast<int>(forward.nodes.size() + backward.nodes.size()) <
+           limit) {
+        bool ahead = backward.next.empty() || (!forward.next.empty() &&
+            forward.next.size() <= backward.next.size());
+        SearchSide &side = ahead ? forward : backward;
+        SearchSide &other = ahead ? backward : forward;
+        auto level = std::move(side.next);
+        side.next.clear();
+
+        for (const auto& entry : level) {
+            std::vector<std::pair<AEGraph, RuleStep>> steps;
+            if (ahead) {
+                for (auto& step : rule_steps(entry.first)) {
+                    steps.push_back({entry.first.apply_step(step), step});
+                }
+            } else {
+                steps = backward_steps(entry.first, max_size);
+            }
+
+            for (const auto& step : steps) {
+                if (!side.add(step.first, entry.second, step.second))
+                    continue;
+                int met = other.find(step.first);
+                if (met != -1) {
+                    int reached = side.nodes.size() - 1;
+                    meet_forward = ahead ? reached : met;
+                    meet_backward = ahead ? met : reached;
+                    break;
+                }
+            }
+            if (meet_forward != -1)
+                break;
+        }
+    }
+
+    proof.forward_graphs = forward.nodes.size();
+    proof.backward_graphs = bidirectional ? backward.nodes.size() : 0;
+    if (meet_forward == -1)
+        return proof;
+
+    proof.found = true;
+    for (int node = meet_forward; forward.nodes[node].parent != -1;
+         node = forward.nodes[node].parent) {
+        proof.steps.push_back(forward.nodes[node].step);
+    }
+    std::reverse(proof.steps.begin(), proof.steps.end());
+    for (int node = meet_backward; backward.nodes[node].parent != -1;
+         node = backward.nodes[node].parent) {
+        proof.steps.push_back(backward.nodes[node].step);
+    }
+    return proof;
+}
@@ -0,0 +1,34 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef BIDIRECTIONAL_SEARCH_H_
+#define BIDIRECTIONAL_SEARCH_H_
+
+#include <vector>
+#include "./aegraph.h"
+
+// A proof of one graph from another that applies the rules to the premise
+// itself instead of reducing the counterset to a contradiction.
+struct ForwardProof {
+    bool found;
+    // the steps that take the sorted premise to the sorted conclusion
+    std::vector<RuleStep> steps;
+    // the distinct graphs each side of the search reached
+    int forward_graphs;
+    int backward_graphs;
+};
+
+// Breadth first search for steps from <premise> to <conclusion>. The
+// forward side applies double cuts, deiterations and erasures to the
+// premise. If <bidirectional>, a backward side also grows the conclusion
+// with the inverse rules: an iteration copies an element of the sheet into
+// a cut, and a double cut goes around one element or around a whole area.
+// The side with the smaller frontier is expanded one level at a time, and
+// the search stops when a graph reached by one side has the canonical
+// hash and form of a graph reached by the other. Every backward graph is
+// stored with the forward step that undoes its inverse rule, so the whole
+// proof is made of forward steps. Every rule makes the graph smaller, so
+// backward graphs larger than the premise are dropped. The search also
+// gives up after <limit> graphs.
+ForwardProof forward_proof(const AEGraph& premise, const AEGraph& conclusion,
+    bool bidirectional = true, int limit = 1 << 20);
+
+#endif  // BIDIRECTIONAL_SEARCH_H_
@@ -0,0 +1,405 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "./formula_io.h"
+
+void conjoin(AEGraph &first, AEGraph second) {
+    // moves the elements of <second> to <first>; the cached sums are left
+    // for the final sort() to compute
+    for (auto& sg : second.subgraphs) {
+        first.subgraphs.push_back(std::move(sg));
+    }
+    for (int i = 0; i < second.num_atoms(); i++) {
+        first.atoms.push_back(std::move(second.atoms[i]));
+        first.atom_ids.push_back(second.atom_ids[i]);
+    }
+}
+
+AEGraph negate(AEGraph graph) {
+    AEGraph result("()");
+    graph.is_SA = false;
+    result.subgraphs.push_back(std::move(graph));
+    return result;
+}
+
+int precedence(char op) {
+    switch (op) {
+        case '!': return 5;
+        case '&': return 4;
+        case '|': return 3;
+        case '>': return 2;
+        case '=': return 1;
+        default: return 0;
+    }
+}
+
+[[noreturn]] void parse_error(const std::string& what, const std::string& text,
+    size_t position) {
+    throw std::invalid_argument(what + " at offset " +
+        std::to_string(position) + " of \"" + text + "\"");
+}
+
+AEGraph from_infix(const std::string& text) {
+    // shunting-yard, with explicit stacks of operators and of values; a
+    // value is a sheet that holds the conjuncts of a subformula. The
+    // checks on <expect_value> and on the parentheses leave every operator
+    // the values it needs.
+    std::vector<AEGraph> values;
+    std::vector<char> ops;
+
+    auto apply = [&](char op) {
+        AEGraph right = std::move(values.back());
+        values.pop_back();
+        if (op == '!') {
+            values.push_back(negate(std::move(right)));
+            return;
+        }
+
+        AEGraph left = std::move(values.back());
+        values.pop_back();
+        if (op == '&') {
+            conjoin(left, std::move(right));
+        } else if (op == '|') {
+            AEGraph both = negate(std::move(left));
+            conjoin(both, negate(std::move(right)));
+            left = negate(std::move(both));
+        } else if (op == '>') {
+            conjoin(left, negate(std::move(right)));
+            left = negate(std::move(left));
+        } else {
+            // both sides are used twice; the copies get ids of their own
+            AEGraph forward = left;
+            AEGraph backward = right;
+            forward.renumber();
+            backward.renumber();
+            conjoin(forward, negate(std::move(backward)));
+            conjoin(right, negate(std::move(left)));
+            left = negate(std::move(forward));
+            conjoin(left, negate(std::move(right)));
+        }
+        values.push_back(std::move(left));
+    };
+
+    bool expect_value = true;
+    size_t i = 0, len = text.size();
+    while (i < len) {
+        char c = text[i];
+        if (isspace(static_cast<unsigned char>(c))) {
+            i++;
+        } else if (isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+                   c == '.') {
+            if (!expect_value)
+                parse_error("expected an operator", text, i);
+            size_t begin = i;
+            while (i < len && (isalnum(static_cast<unsigned char>(text[i])) ||
+                   text[i] == '_' || text[i] == '.'))
+                i++;
+            std::string name = text.substr(begin, i - begin);
+
+            AEGraph value("()");
+            if (name == "false") {
+                value = negate(std::move(value));
+            } else if (name != "true") {
+                value.atoms.push_back(name);
+                value.atom_ids.push_back(AEGraph::new_id());
+            }
+            values.push_back(std::move(value));
+            expect_value = false;
+        } else if (c == '(' || c == '!' || c == '~') {
+            if (!expect_value)
+                parse_error("expected an operator", text, i);
+            ops.push_back(c == '(' ? '(' : '!');
+            i++;
+        } else if (c == ')') {
+            if (expect_value)
+                parse_error("expected a value", text, i);
+            while (!ops.empty() && ops.back() != '(') {
+                apply(ops.back());
+                ops.pop_back();
+            }
+            if (ops.empty())
+                parse_error("unmatched ')'", text, i);
+            ops.pop_back();
+            i++;
+        } else {
+            // a binary operator
+            char op;
+            size_t at = i;
+            if (c == '&' || c == '|') {
+                op = c;
+                i += (i + 1 < len && text[i + 1] == c) ? 2 : 1;
+            } else if (text.compare(i, 2, "->") == 0) {
+                op = '>';
+                i += 2;
+            } else if (text.compare(i, 3, "<->") == 0) {
+                op = '=';
+                i += 3;
+            } else {
+                parse_error(std::string("unexpected '") + c + "'", text, i);
+            }
+            if (expect_value)
+                parse_error("expected a value", text, at);
+
+            // -> groups to the right, the others to the left
+            while (!ops.empty() && ops.back() != '(' &&
+                   (precedence(ops.back()) > precedence(op) ||
+                    (precedence(ops.back()) == precedence(op) && op != '>'))) {
+                apply(ops.back());
+                ops.pop_back();
+            }
+            ops.push_back(op);
+            expect_value = true;
+        }
+    }
+
+    if (expect_value)
+        parse_error("expected a value", text, len);
+    while (!ops.empty()) {
+        if (ops.back() == '(')
+            parse_error("unmatched '('", text, len);
+        apply(ops.back());
+        ops.pop_back();
+    }
+    values.back().sort();
+    return std::move(values.back());
+}
+
+std::string to_infix(const AEGraph& graph) {
+    // written in the order of repr(), with an explicit stack
+    if (graph.size() == 0)
+        return graph.is_SA ? "true" : "false";
+
+    std::string text;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&graph, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        // a cut with one element needs no parentheses
+        bool single = node->size() == 1;
+
+        if (i == 0 && !node->is_SA) {
+            text += node->size() == 0 ? "false" : single ? "!" : "!(";
+        }
+        if (i > 0 && i < node->size()) {
+            text += " & ";
+        }
+        if (i < node->num_subgraphs()) {
+            stack.push_back({&node->subgraphs[i], 0});
+            continue;
+        }
+        if (i < node->size()) {
+            text += node->atoms[i - node->num_subgraphs()];
+            continue;
+        }
+
+        if (!node->is_SA && !single && node->size() > 0) {
+            text += ")";
+        }
+        stack.pop_back();
+    }
+    return text;
+}
+
+bool next_literal(const char *&p, const char *end, int64_t &literal) {
+    // reads the next literal of a DIMACS file, skipping the comments and
+    // the problem line; false at the end of the file
+    while (p < end) {
+        if (isspace(static_cast<unsigned char>(*p))) {
+            p++;
+            continue;
+        }
+        if (*p == '%') {
+            // the end marker of some benchmark files, followed by junk
+            return false;
+        }
+        if (*p == 'c' || *p == 'p') {
+            while (p < end && *p != '\n')
+                p++;
+            continue;
+        }
+
+        const char *begin = p;
+        bool negative = *p == '-';
+        p += negative;
+        if (p == end || !isdigit(static_cast<unsigned char>(*p))) {
+            throw std::invalid_argument("not a DIMACS literal: \"" +
+                std::string(begin, std::min<size_t>(end - begin, 16)) + "\"");
+        }
+        literal = 0;
+        while (p < end && isdigit(static_cast<unsigned char>(*p))) {
+            literal = literal * 10 + (*p++ - '0');
+            if (literal > INT_MAX)
+                throw std::invalid_argument("DIMACS variable out of range");
+        }
+        if (negative)
+            literal = -literal;
+        return true;
+    }
+    return false;
+}
+
+AEGraph from_dimacs(const std::string& text,
+    const std::vector<std::string>& names) {
+    // the names are made once per variable and copied into the atoms
+    std::vector<std::string> atom_names = names;
+    auto name = [&](int variable) -> const std::string& {
+        while (static_cast<int>(atom_names.size()) < variable) {
+            atom_names.push_back("x" + std::to_string(atom_names.size() + 1));
+        }
+        return atom_names[variable - 1];
+    };
+
+    AEGraph sheet("()");
+    AEGraph clause("[]");
+    bool open = false;
+    const char *p = text.c_str();
+    const char *end = p + text.size();
+
+    int64_t literal;
+    while (next_literal(p, end, literal)) {
+        if (literal == 0) {
+            sheet.subgraphs.push_back(std::move(clause));
+            clause = AEGraph("[]");
+            open = false;
+        } else if (literal > 0) {
+            AEGraph negated("[]");
+            negated.atoms.push_back(name(literal));
+            negated.atom_ids.push_back(AEGraph::new_id());
+            clause.subgraphs.push_back(std::move(negated));
+            open = true;
+        } else {
+            clause.atoms.push_back(name(-literal));
+            clause.atom_ids.push_back(AEGraph::new_id());
+            open = true;
+        }
+    }
+    // the last clause may lack its 0
+    if (open)
+        sheet.subgraphs.push_back(std::move(clause));
+
+    sheet.sort();
+    return sheet;
+}
+
+Clauses to_clauses(const AEGraph& graph, std::vector<std::string>& names) {
+    std::map<std::string, int> variables;
+    std::vector<const AEGraph*> stack = {&graph};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back();
+        stack.pop_back();
+        for (const auto& atom : node->atoms) {
+            variables[atom] = 0;
+        }
+        for (const auto& sg : node->subgraphs) {
+            stack.push_back(&sg);
+        }
+    }
+    names.clear();
+    for (auto& entry : variables) {
+        names.push_back(entry.first);
+        entry.second = names.size();
+    }
+
+    // the literal that is true when an element of a cut holds: its atom,
+    // the negated atom of a cut [a] or the variable of another cut
+    int num_variables = names.size();
+    std::unordered_map<const AEGraph*, int> cut_variable;
+    auto literal = [&](const AEGraph& cut) {
+        if (cut.num_subgraphs() == 0 && cut.num_atoms() == 1)
+            return -variables[cut.atoms[0]];
+        return cut_variable[&cut];
+    };
+    // the clause that says not all the elements of <cut> hold, after the
+    // literals in <clause>
+    auto negation = [&](const AEGraph& cut, std::vector<int> clause) {
+        for (const auto& sg : cut.subgraphs) {
+            clause.push_back(-literal(sg));
+        }
+        for (const auto& atom : cut.atoms) {
+            clause.push_back(-variables[atom]);
+        }
+        return clause;
+    };
+
+    Clauses clauses;
+    for (const auto& atom : graph.atoms) {
+        clauses.push_back({variables[atom]});
+    }
+
+    // every cut after the cuts inside it; the cuts on the sheet become
+    // clauses, the deeper ones t <-> not (l1 and ... and lk)
+    std::vector<std::pair<const AEGraph*, int>> order;
+    for (const auto& sg : graph.subgraphs) {
+        order.push_back({&sg, 1});
+    }
+    std::vector<std::pair<const AEGraph*, int>> preorder;
+    while (!order.empty()) {
+        auto top = order.back();
+        order.pop_back();
+        preorder.push_back(top);
+        for (const auto& sg : top.first->subgraphs) {
+            order.push_back({&sg, top.second + 1});
+        }
+    }
+
+    for (auto it = preorder.rbegin(); it != preorder.rend(); ++it) {
+        const AEGraph &cut = *it->first;
+        if (it->second == 1) {
+            clauses.push_back(negation(cut, {}));
+            continue;
+        }
+        if (cut.num_subgraphs() == 0 && cut.num_atoms() == 1)
+            continue;
+
+        int t = cut_variable[&cut] = ++num_variables;
+        clauses.push_back(negation(cut, {-t}));
+        for (const auto& sg : cut.subgraphs) {
+            clauses.push_back({t, literal(sg)});
+        }
+        for (const auto& atom : cut.atoms) {
+            clauses.push_back({t, variables[atom]});
+        }
+    }
+    return clauses;
+}
+
+std::string to_dimacs(const AEGraph& graph, std::vector<std::string>& names) {
+    Clauses clauses = to_clauses(graph, names);
+    int num_variables = names.size();
+    std::string text;
+    for (const auto& clause : clauses) {
+        for (int literal : clause) {
+            num_variables = std::max(num_variables, std::abs(literal));
+            text += std::to_string(literal) + " ";
+        }
+        text += "0\n";
+    }
+    return "p cnf " + std::to_string(num_variables) + " " +
+        std::to_string(clauses.size()) + "\n" + text;
+}
+
+bool satisfiable(const std::string& dimacs) {
+    Clauses clauses(1);
+    const char *p = dimacs.c_str();
+    const char *end = p + dimacs.size();
+    int64_t literal;
+    while (next_literal(p, end, literal)) {
+        if (literal == 0)
+            clauses.emplace_back();
+        else
+            clauses.back().push_back(literal);
+    }
+    // the last clause may lack its 0
+    if (clauses.back().empty())
+        clauses.pop_back();
+    return satisfiable(clauses);
+}
@@ -0,0 +1,42 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef FORMULA_IO_H_
+#define FORMULA_IO_H_
+
+#include <vector>
+#include <string>
+#include "./aegraph.h"
+#include "./sat_solver.h"
+
+// Conversions between graphs and propositional formulas. The readers build
+// the cuts and atoms directly and sort the graph once at the end, without
+// going through the bracket syntax; they throw std::invalid_argument on
+// malformed text.
+
+// "a & !(b | c) -> d": atoms are names made of letters, digits, '_' and
+// '.', "true" and "false" are the constants; from the tightest binding,
+// the operators are ! (or ~), & (or &&), | (or ||), -> (to the right) and
+// <->. A conjunction is a juxtaposition and a negation is a cut, so
+// a | b is [[a], [b]] and a -> b is [a, [b]].
+AEGraph from_infix(const std::string& text);
+// the inverse of from_infix(): a cut is written !x if it holds one
+// element and !(x & y) otherwise; the empty cut is false and the empty
+// sheet is true
+std::string to_infix(const AEGraph& graph);
+
+// a DIMACS CNF file: every clause becomes a cut that holds the negations
+// of its literals, so a -b is [[a], b]; variable n is called names[n - 1],
+// or "x<n>" if there is no such name
+AEGraph from_dimacs(const std::string& text,
+    const std::vector<std::string>& names = {});
+// clauses that are satisfiable exactly when the graph is: the atoms are
+// variables 1 to names.size(), in the order of <names>, which is filled
+// in; cuts below the outermost ones that are not a negated atom get a
+// variable of their own (the Tseitin encoding)
+Clauses to_clauses(const AEGraph& graph, std::vector<std::string>& names);
+// the same clauses as a DIMACS CNF file
+std::string to_dimacs(const AEGraph& graph, std::vector<std::string>& names);
+
+// whether a DIMACS CNF file is satisfiable, by the solver of sat_solver.h
+bool satisfiable(const std::string& dimacs);
+
+#endif  // FORMULA_IO_H_
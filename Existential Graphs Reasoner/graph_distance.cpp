@@ -0,0 +1,234 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include "./graph_distance.h"
+
+TreeDistance::Tree::Tree(const AEGraph& graph) : size(0) {
+    // a postorder walk with an explicit stack; the atoms of a cut come
+    // after its subgraphs, like in repr()
+    struct Frame {
+        const AEGraph *node;
+        int next;
+        int cuts;
+        int leftmost;
+        std::vector<int> children;
+    };
+
+    hash.push_back(0);
+    label.push_back("");
+    leftmost.push_back(0);
+    children.push_back({});
+
+    auto add = [&](const std::string& text, int cuts, int first,
+        std::vector<int> nodes) {
+        // numbers a node whose children are all numbered
+        size++;
+        label.push_back((cuts % 2 == 0 ? "+" : "-") + text);
+        hash.push_back(atom_hash(label.back()));
+        leftmost.push_back(first ? first : size);
+        children.push_back(std::move(nodes));
+        return size;
+    };
+
+    std::vector<Frame> stack;
+    stack.push_back({&graph, 0, 0, 0, {}});
+    while (!stack.empty()) {
+        Frame &top = stack.back();
+        const AEGraph *node = top.node;
+        int i = top.next++;
+
+        if (i < node->num_subgraphs()) {
+            int cuts = top.cuts + (node->is_SA ? 0 : 1);
+            stack.push_back({&node->subgraphs[i], 0, cuts, 0, {}});
+            continue;
+        }
+
+        int index;
+        if (i < node->size()) {
+            int cuts = top.cuts + (node->is_SA ? 0 : 1);
+            index = add(node->atoms[i - node->num_subgraphs()], cuts, 0, {});
+        } else {
+            Frame done = std::move(top);
+            stack.pop_back();
+            index = add(node->is_SA ? "()" : "[]", done.cuts, done.leftmost,
+                std::move(done.children));
+            if (stack.empty())
+                break;
+        }
+
+        Frame &parent = stack.back();
+        if (!parent.leftmost)
+            parent.leftmost = leftmost[index];
+        parent.children.push_back(index);
+    }
+
+    // the highest node with a given leftmost leaf
+    std::map<int, int> highest;
+    for (int i = 1; i <= size; i++) {
+        highest[leftmost[i]] = i;
+    }
+    for (const auto& entry : highest) {
+        keyroots.push_back(entry.second);
+    }
+    std::sort(keyroots.begin(), keyroots.end());
+
+    counts.assign(hash.begin() + 1, hash.end());
+    std::sort(counts.begin(), counts.end());
+}
+
+int TreeDistance::lower_bound(const Tree& a, const Tree& b) {
+    // every edit changes the size by at most 1, and the count of at most
+    // two labels by 1 each
+    size_t i = 0, j = 0;
+    int common = 0;
+    while (i < a.counts.size() && j < b.counts.size()) {
+        if (a.counts[i] < b.counts[j]) {
+            i++;
+        } else if (b.counts[j] < a.counts[i]) {
+            j++;
+        } else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    int apart = a.size + b.size - 2 * common;
+    return std::max(std::abs(a.size - b.size), (apart + 1) / 2);
+}
+
+int TreeDistance::distance(const Tree& a, const Tree& b) {
+    // tree[i][j] is the distance between the subtrees rooted at i and j,
+    // filled in for every pair of keyroots from the smallest; forest holds
+    // the distances between prefixes of the two forests below them
+    int width = b.size + 1;
+    std::vector<int> tree((a.size + 1) * width, 0);
+    std::vector<int> forest;
+
+    for (int i : a.keyroots) {
+        for (int j : b.keyroots) {
+            int li = a.leftmost[i], lj = b.leftmost[j];
+            int rows = i - li + 2, cols = j - lj + 2;
+            forest.assign(rows * cols, 0);
+            for (int x = 1; x < rows; x++)
+                forest[x * cols] = x;
+            for (int y = 1; y < cols; y++)
+                forest[y] = y;
+
+            for (int x = li; x <= i; x++) {
+                for (int y = lj; y <= j; y++) {
+                    int fx = x - li + 1, fy = y - lj + 1;
+                    int best = std::min(forest[(fx - 1) * cols + fy],
+                        forest[fx * cols + fy - 1]) + 1;
+
+                    if (a.leftmost[x] == li && b.leftmost[y] == lj) {
+                        // two whole trees: the roots are matched
+                        int relabel = a.hash[x] == b.hash[y] &&
+                            a.label[x] == b.label[y] ? 0 : 1;
+                        best = std::min(best,
+                            forest[(fx - 1) * cols + fy - 1] + relabel);
+                        tree[x * width + y] = best;
+                    } else {
+                        int px = a.leftmost[x] - li, py = b.leftmost[y] - lj;
+                        best = std::min(best,
+                            forest[px * cols + py] + tree[x * width + y]);
+                    }
+                    forest[fx * cols + fy] = best;
+                }
+            }
+        }
+    }
+    return tree[a.size * width + b.size];
+}
+
+int TreeDistance::top_down(const Tree& a, const Tree& b) {
+    // cost[u, v] = relabel(u, v) + the cheapest alignment of the children
+    // of u and v, where a child is deleted or inserted with its subtree;
+    // the pairs are evaluated with an explicit stack
+    std::unordered_map<int64_t, int> cost;
+    auto key = [&](int u, int v) {
+        return static_cast<int64_t>(u) * (b.size + 1) + v;
+    };
+    auto weight = [](const Tree& t, int u) {
+        return u - t.leftmost[u] + 1;
+    };
+
+    std::vector<std::pair<int, int>> stack = {{a.size, b.size}};
+    std::vector<int> align;
+    while (!stack.empty()) {
+        int u = stack.back().first, v = stack.back().second;
+        if (cost.count(key(u, v))) {
+            stack.pop_back();
+            continue;
+        }
+
+        const auto &cu = a.children[u], &cv = b.children[v];
+        bool ready = true;
+        for (int x : cu) {
+            for (int y : cv) {
+                if (!cost.count(key(x, y))) {
+                    stack.push_back({x, y});
+                    ready = false;
+                }
+            }
+        }
+        if (!ready)
+            continue;
+
+        int cols = cv.size() + 1;
+        align.assign((cu.size() + 1) * cols, 0);
+        for (size_t x = 1; x <= cu.size(); x++)
+            align[x * cols] = align[(x - 1) * cols] + weight(a, cu[x - 1]);
+        for (size_t y = 1; y <= cv.size(); y++)
+            align[y] = align[y - 1] + weight(b, cv[y - 1]);
+        for (size_t x = 1; x <= cu.size(); x++) {
+            for (size_t y = 1; y <= cv.size(); y++) {
+                align[x * cols + y] = std::min({
+                    align[(x - 1) * cols + y] + weight(a, cu[x - 1]),
+                    align[x * cols + y - 1] + weight(b, cv[y - 1]),
+                    align[(x - 1) * cols + y - 1] +
+                        cost[key(cu[x - 1], cv[y - 1])]});
+            }
+        }
+
+        int relabel = a.hash[u] == b.hash[v] && a.label[u] == b.label[v] ?
+            0 : 1;
+        cost[key(u, v)] = relabel + align.back();
+        stack.pop_back();
+    }
+    return cost[key(a.size, b.size)];
+}
+
+TreeDistance::TreeDistance(const AEGraph& target) : target(target) {
+}
+
+int TreeDistance::operator()(const AEGraph& graph) const {
+    return distance(Tree(graph), target);
+}
+
+int TreeDistance::operator()(const AEGraph& graph, int bound) const {
+    Tree tree(graph);
+    if (lower_bound(tree, target) > bound)
+        return bound + 1;
+    return std::min(distance(tree, target), bound + 1);
+}
+
+int TreeDistance::approximate(const AEGraph& graph) const {
+    return top_down(Tree(graph), target);
+}
+
+int tree_distance(const AEGraph& a, const AEGraph& b) {
+    return TreeDistance(b)(a);
+}
+
+int tree_distance(const AEGraph& a, const AEGraph& b, int bound) {
+    return TreeDistance(b)(a, bound);
+}
+
+int approximate_distance(const AEGraph& a, const AEGraph& b) {
+    return TreeDistance(b).approximate(a);
+}
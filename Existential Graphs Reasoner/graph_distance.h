@@ -0,0 +1,58 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef GRAPH_DISTANCE_H_
+#define GRAPH_DISTANCE_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "./aegraph.h"
+
+// Ordered tree edit distance between graphs in canonical order: every cut
+// and every atom is a node, and inserting, deleting or relabelling a node
+// costs 1. A label is the atom (or "cut") together with the parity of the
+// area it lies in, so moving an atom under a cut also relabels it.
+
+// the exact distance (Zhang and Shasha), in O(n1 n2) memory and
+// O(n1 n2 min(depth, leaves)^2) time
+int tree_distance(const AEGraph& a, const AEGraph& b);
+// min(distance, bound + 1): pairs that the lower bounds (difference of
+// sizes and of label counts) put further than <bound> are not compared
+int tree_distance(const AEGraph& a, const AEGraph& b, int bound);
+// an upper bound for large trees: the distance when nodes are only matched
+// at the same depth and under matched parents (Selkow's top-down distance)
+int approximate_distance(const AEGraph& a, const AEGraph& b);
+
+// the distance to a fixed graph, as a heuristic for best-first search:
+// the target is laid out once and every call only lays out its argument
+class TreeDistance {
+ public:
+    explicit TreeDistance(const AEGraph& target);
+    int operator()(const AEGraph& graph) const;
+    int operator()(const AEGraph& graph, int bound) const;
+    int approximate(const AEGraph& graph) const;
+
+ private:
+    // the nodes of a graph in postorder, numbered from 1
+    struct Tree {
+        explicit Tree(const AEGraph& graph);
+
+        std::vector<uint64_t> hash;
+        std::vector<std::string> label;
+        // the leftmost leaf below every node, and the nodes that are not
+        // the leftmost child of their parent (and the root)
+        std::vector<int> leftmost;
+        std::vector<int> keyroots;
+        std::vector<std::vector<int>> children;
+        // the label hashes, sorted, for the lower bound
+        std::vector<uint64_t> counts;
+        int size;
+    };
+
+    static int distance(const Tree& a, const Tree& b);
+    static int lower_bound(const Tree& a, const Tree& b);
+    static int top_down(const Tree& a, const Tree& b);
+
+    Tree target;
+};
+
+#endif  // GRAPH_DISTANCE_H_
@@ -0,0 +1,179 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include "./aegraph.h"
+#include "./formula_io.h"
+#include "./sat_solver.h"
+
+// AEGraph::equivalent(), kept apart from the rest of the class since its
+// last stage needs the CNF encoding of formula_io.h and the SAT solver
+
+AEGraph normal_form(const AEGraph& graph) {
+    // a copy without double cuts and with the equal elements of an area
+    // merged, built bottom-up through insert_subgraph() and insert_atom()
+    // so that every node keeps its hash, sums and label. The children of a
+    // node are normal when it is built, so one pass is enough: a lifted
+    // double cut brings up normal elements, and merging can only turn the
+    // node itself into a double cut, which its parent lifts.
+    std::vector<AEGraph> built;
+    std::vector<std::pair<const AEGraph*, bool>> stack = {{&graph, false}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        if (!stack.back().second) {
+            stack.back().second = true;
+            // the first subgraph is built first
+            for (int i = node->num_subgraphs() - 1; i >= 0; i--) {
+                stack.push_back({&node->subgraphs[i], false});
+            }
+            continue;
+        }
+        stack.pop_back();
+
+        AEGraph result(node->is_SA ? "()" : "[]");
+        size_t first = built.size() - node->num_subgraphs();
+        for (size_t k = first; k < built.size(); k++) {
+            AEGraph &sg = built[k];
+            if (sg.num_subgraphs() != 1 || sg.num_atoms() != 0) {
+                result.insert_subgraph(std::move(sg));
+                continue;
+            }
+            AEGraph inner = sg.take_subgraph(0);
+            while (inner.num_subgraphs() > 0) {
+                result.insert_subgraph(
+                    inner.take_subgraph(inner.num_subgraphs() - 1));
+            }
+            for (int i = 0; i < inner.num_atoms(); i++) {
+                result.insert_atom(inner.atoms[i], inner.atom_ids[i]);
+            }
+        }
+        built.erase(built.begin() + first, built.end());
+        for (int i = 0; i < node->num_atoms(); i++) {
+            result.insert_atom(node->atoms[i], node->atom_ids[i]);
+        }
+
+        // equal elements are next to each other in canonical order
+        for (int i = result.num_atoms() - 1; i > 0; i--) {
+            if (result.atoms[i] == result.atoms[i - 1])
+                result.remove_atom(i);
+        }
+        for (int i = result.num_subgraphs() - 1; i > 0; i--) {
+            if (result.subgraphs[i] == result.subgraphs[i - 1])
+                result.remove_subgraph(i);
+        }
+        built.push_back(std::move(result));
+    }
+    return std::move(built.back());
+}
+
+std::vector<int> truth_program(const AEGraph& graph,
+    const std::map<std::string, int>& variables) {
+    // the graph in postorder, for evaluate(): an atom is its variable, -1
+    // opens a cut and -2 closes it
+    std::vector<int> program;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&graph, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        if (i < node->num_subgraphs()) {
+            program.push_back(-1);
+            stack.push_back({&node->subgraphs[i], 0});
+            continue;
+        }
+        for (const auto& atom : node->atoms) {
+            program.push_back(variables.at(atom));
+        }
+        if (stack.size() > 1)
+            program.push_back(-2);
+        stack.pop_back();
+    }
+    return program;
+}
+
+uint64_t evaluate(const std::vector<int>& program,
+    const std::vector<uint64_t>& values, std::vector<uint64_t>& stack) {
+    // the truth of the graph under 64 assignments at once: bit k of
+    // values[v] is the value of variable v in assignment k
+    stack.assign(1, ~0ULL);
+    for (int op : program) {
+        if (op >= 0) {
+            stack.back() &= values[op];
+        } else if (op == -1) {
+            stack.push_back(~0ULL);
+        } else {
+            uint64_t cut = ~stack.back();
+            stack.pop_back();
+            stack.back() &= cut;
+        }
+    }
+    return stack.back();
+}
+
+bool AEGraph::equivalent(const AEGraph& other) const {
+    // the cheap checks first: equal canonical forms, then equal forms once
+    // double cuts and repeated elements are gone
+    AEGraph a = *this, b = other;
+    a.sort();
+    b.sort();
+    if (a.hash() == b.hash() && a.repr() == b.repr())
+        return true;
+    a = normal_form(a);
+    b = normal_form(b);
+    if (a.hash() == b.hash() && a.repr() == b.repr())
+        return true;
+
+    // then the two graphs are evaluated 64 assignments at a time, on all
+    // of them for few atoms and on random ones otherwise; an assignment
+    // where they differ is a counter-model
+    std::map<std::string, int> variables;
+    std::vector<const AEGraph*> stack = {&a, &b};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back();
+        stack.pop_back();
+        for (const auto& atom : node->atoms) {
+            variables.insert({atom, 0});
+        }
+        for (const auto& sg : node->subgraphs) {
+            stack.push_back(&sg);
+        }
+    }
+    int n = 0;
+    for (auto& entry : variables) {
+        entry.second = n++;
+    }
+    std::vector<int> first = truth_program(a, variables);
+    std::vector<int> second = truth_program(b, variables);
+
+    const int exhaustive = 20;
+    const uint64_t patterns[] = {
+        0xaaaaaaaaaaaaaaaaULL, 0xccccccccccccccccULL, 0xf0f0f0f0f0f0f0f0ULL,
+        0xff00ff00ff00ff00ULL, 0xffff0000ffff0000ULL, 0xffffffff00000000ULL};
+    // with fewer than 6 atoms the extra bits repeat assignments
+    uint64_t words = n <= exhaustive ? 1ULL << std::max(n - 6, 0) : 256;
+    std::vector<uint64_t> values(n), scratch;
+    for (uint64_t word = 0; word < words; word++) {
+        for (int v = 0; v < n; v++) {
+            if (n > exhaustive)
+                values[v] = mix64(word * n + v + 1);
+            else if (v < 6)
+                values[v] = patterns[v];
+            else
+                values[v] = (word >> (v - 6) & 1) ? ~0ULL : 0;
+        }
+        if (evaluate(first, values, scratch) !=
+            evaluate(second, values, scratch))
+            return false;
+    }
+    if (n <= exhaustive)
+        return true;
+
+    // the graphs differ exactly when (a, [b]) or (b, [a]) is satisfiable,
+    // that is when [[a, [b]], [b, [a]]] is
+    AEGraph differ = enclose(juxtapose(enclose(counterset(a, b)),
+        enclose(counterset(b, a))));
+    std::vector<std::string> names;
+    return !satisfiable(to_clauses(differ, names));
+}
@@ -0,0 +1,405 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <cassert>
+#include "./graph_pattern.h"
+
+bool PatternMatch::operator<(const PatternMatch& other) const {
+    return std::make_pair(path, bindings) <
+        std::make_pair(other.path, other.bindings);
+}
+
+bool PatternMatch::operator==(const PatternMatch& other) const {
+    return path == other.path && bindings == other.bindings;
+}
+
+GraphPattern::GraphPattern(std::string representation) : root() {
+    // same syntax as AEGraph, where an element may also be "?Name" or "..."
+    char left_sep = representation[0];
+    char right_sep = representation[representation.size() - 1];
+    assert((left_sep == '(' && right_sep == ')')
+        || (left_sep == '[' && right_sep == ']'));
+    root.is_SA = left_sep == '(';
+
+    std::vector<Node> open;
+    std::string element;
+    bool closed = false;
+
+    auto finish_element = [&](Node &area) {
+        size_t first = element.find_first_not_of(" \n\r\t");
+        std::string text;
+        if (first != std::string::npos)
+            text = element.substr(first,
+                element.find_last_not_of(" \n\r\t") - first + 1);
+        assert(!closed || text.empty());
+
+        if (!closed && text == "...") {
+            area.rest = true;
+        } else if (!closed && !text.empty() && text[0] == '?') {
+            assert(text.size() > 1);
+            area.variables.push_back(text.substr(1));
+        } else if (!closed && !text.empty()) {
+            area.atoms.push_back(text);
+        }
+        element.clear();
+        closed = false;
+    };
+
+    int len = representation.size();
+    for (int i = 1; i < len - 1; i++) {
+        char c = representation[i];
+        if (c == '[') {
+            assert(!closed && element.find_first_not_of(" \n\r\t") ==
+                std::string::npos);
+            open.push_back(Node());
+        } else if (c == ',') {
+            finish_element(open.empty() ? root : open.back());
+        } else if (c == ']') {
+            assert(!open.empty());
+            finish_element(open.back());
+            Node cut = std::move(open.back());
+            open.pop_back();
+            (open.empty() ? root : open.back()).subgraphs.push_back(
+                std::move(cut));
+            closed = true;
+        } else {
+            element += c;
+        }
+    }
+    assert(open.empty());
+    finish_element(root);
+
+    finish(root);
+}
+
+void GraphPattern::finish(Node &node) {
+    // marks the ground nodes and computes their hashes; patterns are
+    // written by hand and shallow, so they are walked recursively
+    node.ground = node.variables.empty() && !node.rest;
+    for (auto& sg : node.subgraphs) {
+        finish(sg);
+        node.ground = node.ground && sg.ground;
+    }
+    std::sort(node.atoms.begin(), node.atoms.end());
+    std::sort(node.variables.begin(), node.variables.end());
+    // ground subgraphs are only counted, so they are kept apart from the
+    // others, which are sorted to bring equal ones together
+    auto first_free = std::stable_partition(node.subgraphs.begin(),
+        node.subgraphs.end(), [](const Node& sg) { return sg.ground; });
+    node.num_ground = first_free - node.subgraphs.begin();
+    std::sort(node.subgraphs.begin(), first_free,
+        [](const Node& a, const Node& b) { return a.text < b.text; });
+    std::sort(first_free, node.subgraphs.end(),
+        [](const Node& a, const Node& b) { return a.text < b.text; });
+
+    if (!node.ground) {
+        // only tells equal patterns apart, it is never parsed
+        std::vector<std::string> parts;
+        for (const auto& sg : node.subgraphs) {
+            parts.push_back(sg.text);
+        }
+        parts.insert(parts.end(), node.atoms.begin(), node.atoms.end());
+        for (const auto& name : node.variables) {
+            parts.push_back("?" + name);
+        }
+        if (node.rest)
+            parts.push_back("...");
+        node.text = node.is_SA ? "(" : "[";
+        for (const auto& part : parts) {
+            node.text += part + ", ";
+        }
+        node.text += node.is_SA ? ")" : "]";
+        return;
+    }
+
+    std::string text;
+    for (const auto& sg : node.subgraphs) {
+        text += sg.text + ", ";
+    }
+    for (const auto& atom : node.atoms) {
+        text += atom + ", ";
+    }
+    if (!text.empty())
+        text.resize(text.size() - 2);
+    AEGraph graph(node.is_SA ? "(" + text + ")" : "[" + text + "]");
+    node.text = graph.repr();
+    node.hash = graph.hash();
+}
+
+bool GraphPattern::fits(const Node& pattern, const AEGraph& area,
+    const std::vector<bool> &used) {
+    // whether the unused elements of <area> hold the atoms and the ground
+    // subgraphs of <pattern>; which of several equal elements one of them
+    // takes makes no difference, so they are counted instead of placed
+    int len_subgraphs = area.num_subgraphs();
+    size_t i = 0;
+    while (i < pattern.atoms.size()) {
+        size_t next = i;
+        while (next < pattern.atoms.size() &&
+                pattern.atoms[next] == pattern.atoms[i])
+            next++;
+        auto range = std::equal_range(area.atoms.begin(), area.atoms.end(),
+            pattern.atoms[i]);
+        size_t free = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            free += !used[len_subgraphs + (it - area.atoms.begin())];
+        }
+        if (free < next - i)
+            return false;
+        i = next;
+    }
+
+    i = 0;
+    while (i < pattern.num_ground) {
+        const Node &sub = pattern.subgraphs[i];
+        size_t next = i;
+        while (next < pattern.num_ground &&
+                pattern.subgraphs[next].text == sub.text)
+            next++;
+        size_t free = 0;
+        for (int j = 0; j < len_subgraphs && free < next - i; j++) {
+            free += !used[j] && area.subgraphs[j].hash() == sub.hash &&
+                area.subgraphs[j].repr() == sub.text;
+        }
+        if (free < next - i)
+            return false;
+        i = next;
+    }
+    return true;
+}
+
+void GraphPattern::match(const Node& pattern, const AEGraph& area,
+    std::vector<int> &path, Bindings &bindings,
+    const std::function<void()> &found) const {
+    // calls found() once for every way in which <area> (at <path>) matches
+    // <pattern>, with the variables of <pattern> added to <bindings>
+    if (pattern.ground) {
+        if (area.hash() == pattern.hash && area.repr() == pattern.text)
+            found();
+        return;
+    }
+
+    int needed = pattern.atoms.size() + pattern.subgraphs.size() +
+        pattern.variables.size();
+    if (area.size() < needed || (!pattern.rest && area.size() > needed))
+        return;
+
+    std::vector<bool> used(area.size());
+    if (fits(pattern, area, used))
+        assign(pattern, area, 0, 0, used, path, bindings, found);
+}
+
+void GraphPattern::assign(const Node& pattern, const AEGraph& area,
+    size_t element, int from, std::vector<bool> &used,
+    std::vector<int> &path, Bindings &bindings,
+    const std::function<void()> &found) const {
+    // places the pattern's elements from <element> on, in order: the
+    // subgraphs that are not ground, then the variables, each on an element
+    // of <area> that is not used yet; the atoms and the ground subgraphs
+    // are counted at the end. Equal elements of the pattern take increasing
+    // positions, so this one starts at <from> and no placement is repeated.
+    size_t num_subgraphs = pattern.subgraphs.size() - pattern.num_ground;
+    int len_subgraphs = area.num_subgraphs();
+    if (element == num_subgraphs + pattern.variables.size()) {
+        if (fits(pattern, area, used))
+            found();
+        return;
+    }
+
+    if (element < num_subgraphs) {
+        const auto &subgraphs = pattern.subgraphs;
+        size_t index = pattern.num_ground + element;
+        const Node &sub = subgraphs[index];
+        bool twin = index + 1 < subgraphs.size() &&
+            subgraphs[index + 1].text == sub.text;
+        for (int j = from; j < len_subgraphs; j++) {
+            if (used[j])
+                continue;
+            used[j] = true;
+            path.push_back(j);
+            // the rest of this area is placed once the subgraph matched
+            match(sub, area.subgraphs[j], path, bindings, [&]() {
+                path.pop_back();
+                assign(pattern, area, element + 1, twin ? j + 1 : 0, used,
+                    path, bindings, found);
+                path.push_back(j);
+            });
+            path.pop_back();
+            used[j] = false;
+        }
+        return;
+    }
+
+    size_t index = element - num_subgraphs;
+    const std::string &name = pattern.variables[index];
+    bool twin = index + 1 < pattern.variables.size() &&
+        pattern.variables[index + 1] == name;
+    bool bound = bindings.count(name);
+    for (int j = from; j < area.size(); j++) {
+        if (used[j])
+            continue;
+
+        Binding candidate;
+        candidate.path = path;
+        candidate.path.push_back(j);
+        candidate.subgraph = j < len_subgraphs ? &area.subgraphs[j] : nullptr;
+        candidate.atom = j < len_subgraphs ? nullptr :
+            &area.atoms[j - len_subgraphs];
+        candidate.hash = j < len_subgraphs ? area.subgraphs[j].hash() :
+            atom_hash(*candidate.atom);
+
+        if (bound) {
+            // another occurrence: the element must equal the first one,
+            // which the hashes decide unless they collide
+            const Binding &first = bindings[name];
+            if (first.hash != candidate.hash)
+                continue;
+            if (first.subgraph ? !candidate.subgraph ||
+                    *first.subgraph != *candidate.subgraph :
+                    !candidate.atom || *first.atom != *candidate.atom)
+                continue;
+            // a variable reports the first of its occurrences
+            std::vector<int> previous = first.path;
+            bindings[name].path = std::min(previous, candidate.path);
+            used[j] = true;
+            assign(pattern, area, element + 1, twin ? j + 1 : 0, used, path,
+                bindings, found);
+            used[j] = false;
+            bindings[name].path = previous;
+        } else {
+            used[j] = true;
+            bindings[name] = candidate;
+            assign(pattern, area, element + 1, twin ? j + 1 : 0, used, path,
+                bindings, found);
+            bindings.erase(name);
+            used[j] = false;
+        }
+    }
+}
+
+void GraphPattern::collect(const AEGraph& node, std::vector<int> &path,
+    std::vector<PatternMatch> &found) const {
+    // the placements that differ only in elements no variable reports,
+    // or in occurrences of a variable that do not come first, agree; the
+    // set keeps one of each, in order of the bindings
+    std::set<std::map<std::string, std::vector<int>>> occurrences;
+    Bindings bindings;
+    match(root, node, path, bindings, [&]() {
+        std::map<std::string, std::vector<int>> reported;
+        for (const auto& binding : bindings) {
+            reported[binding.first] = binding.second.path;
+        }
+        occurrences.insert(std::move(reported));
+    });
+
+    for (const auto& reported : occurrences) {
+        PatternMatch occurrence;
+        occurrence.path = path;
+        occurrence.bindings = reported;
+        found.push_back(occurrence);
+    }
+}
+
+std::vector<PatternMatch> GraphPattern::matches(const AEGraph& graph) const {
+    // the cuts are visited in preorder, which is the lexicographic order
+    // of their paths, so the matches come out sorted
+    std::vector<PatternMatch> found;
+    std::vector<int> path;
+
+    if (root.is_SA) {
+        // a pattern of a whole sheet only matches the sheet
+        collect(graph, path, found);
+        return found;
+    }
+
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&graph, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        if (i >= node->num_subgraphs()) {
+            stack.pop_back();
+            if (!path.empty())
+                path.pop_back();
+            continue;
+        }
+
+        path.push_back(i);
+        collect(node->subgraphs[i], path, found);
+        stack.push_back({&node->subgraphs[i], 0});
+    }
+    return found;
+}
+
+std::vector<PatternMatch> GraphPattern::matches_at(const AEGraph& graph,
+    const std::vector<int>& where) const {
+    std::vector<PatternMatch> found;
+    if (root.is_SA != where.empty())
+        return found;
+
+    const AEGraph *node = &graph;
+    for (int index : where) {
+        node = &node->subgraphs[index];
+    }
+    std::vector<int> path = where;
+    collect(*node, path, found);
+    return found;
+}
+
+int PatternIndex::add(const AEGraph& pattern) {
+    texts.push_back(pattern.repr());
+    by_hash.emplace(pattern.hash(), texts.size() - 1);
+    return texts.size() - 1;
+}
+
+int PatternIndex::size() const {
+    return texts.size();
+}
+
+std::vector<std::pair<int, std::vector<int>>> PatternIndex::find_all(
+    const AEGraph& graph) const {
+    // like get_paths_to(), only subgraphs that are not alone in their area
+    // count; a subgraph is serialized only when some pattern has its hash
+    std::vector<std::pair<int, std::vector<int>>> found;
+    std::vector<int> path;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&graph, 0}};
+
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        if (i >= node->num_subgraphs()) {
+            stack.pop_back();
+            if (!path.empty())
+                path.pop_back();
+            continue;
+        }
+
+        const AEGraph &sg = node->subgraphs[i];
+        path.push_back(i);
+        if (node->size() > 1) {
+            auto range = by_hash.equal_range(sg.hash());
+            std::string text;
+            if (range.first != range.second)
+                text = sg.repr();
+
+            std::vector<int> patterns;
+            for (auto it = range.first; it != range.second; ++it) {
+                if (texts[it->second] == text)
+                    patterns.push_back(it->second);
+            }
+            std::sort(patterns.begin(), patterns.end());
+            for (int pattern : patterns) {
+                found.push_back({pattern, path});
+            }
+        }
+        // other patterns may still occur inside a matched subgraph
+        stack.push_back({&sg, 0});
+    }
+
+    return found;
+}
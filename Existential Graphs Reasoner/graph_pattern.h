@@ -0,0 +1,102 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef GRAPH_PATTERN_H_
+#define GRAPH_PATTERN_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include "./aegraph.h"
+
+// an occurrence of a pattern: the path of the matched cut (empty when the
+// pattern is a whole sheet of assertion) and, for every variable, the
+// (lexicographically first) path of an element it stands for
+struct PatternMatch {
+    std::vector<int> path;
+    std::map<std::string, std::vector<int>> bindings;
+
+    bool operator<(const PatternMatch& other) const;
+    bool operator==(const PatternMatch& other) const;
+};
+
+// A graph with holes. "?X" stands for any atom or subgraph, and every "?X"
+// of a pattern for equal ones; "..." stands for any number of further
+// elements of its area. "[?X, [?X]]" matches the cuts that hold exactly an
+// element and a cut around a copy of it, "[[?Y], ...]" the cuts that hold
+// (at least) a cut with a single element.
+class GraphPattern {
+ public:
+    explicit GraphPattern(std::string representation);
+
+    // every occurrence in <graph>, in lexicographic order of (path,
+    // bindings); the cuts are visited once each and every cut is searched
+    // for the pattern on its own
+    std::vector<PatternMatch> matches(const AEGraph& graph) const;
+
+    // the occurrences at the cut at <where> only
+    std::vector<PatternMatch> matches_at(const AEGraph& graph,
+        const std::vector<int>& where) const;
+
+ private:
+    struct Node {
+        bool is_SA;
+        std::vector<std::string> atoms;
+        std::vector<Node> subgraphs;
+        std::vector<std::string> variables;
+        bool rest;
+        // a node without variables and "..." matches only equal subgraphs,
+        // which are found by their hash and confirmed by their text
+        bool ground;
+        uint64_t hash;
+        // the repr of a ground node, a canonical form of the others
+        std::string text;
+        // the ground subgraphs come first
+        size_t num_ground;
+    };
+
+    struct Binding {
+        std::vector<int> path;
+        uint64_t hash;
+        const AEGraph *subgraph;
+        const std::string *atom;
+    };
+    using Bindings = std::map<std::string, Binding>;
+
+    static void finish(Node &node);
+    static bool fits(const Node& pattern, const AEGraph& area,
+        const std::vector<bool> &used);
+    void match(const Node& pattern, const AEGraph& area,
+        std::vector<int> &path, Bindings &bindings,
+        const std::function<void()> &found) const;
+    void assign(const Node& pattern, const AEGraph& area, size_t element,
+        int from, std::vector<bool> &used, std::vector<int> &path,
+        Bindings &bindings, const std::function<void()> &found) const;
+    void collect(const AEGraph& node, std::vector<int> &path,
+        std::vector<PatternMatch> &found) const;
+
+    Node root;
+};
+
+// Fixed subgraphs that are searched for together. They are indexed by
+// their hash, so one traversal of a graph finds the occurrences of all of
+// them instead of one get_paths_to() call per pattern.
+class PatternIndex {
+ public:
+    // returns the number of the pattern, counting from 0
+    int add(const AEGraph& pattern);
+    int size() const;
+
+    // every (pattern, path) with the path in get_paths_to(pattern), in
+    // lexicographic order of the path and then by pattern number
+    std::vector<std::pair<int, std::vector<int>>> find_all(
+        const AEGraph& graph) const;
+
+ private:
+    std::vector<std::string> texts;
+    std::unordered_multimap<uint64_t, int> by_hash;
+};
+
+#endif  // GRAPH_PATTERN_H_
@@ -0,0 +1,350 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <utility>
+#include <unordered_set>
+#include "./knowledge_base.h"
+
+bool is_contradiction(const AEGraph& graph) {
+    if (graph.num_atoms() != 1 || graph.num_subgraphs() != 1)
+        return false;
+
+    const AEGraph& cut = graph.subgraphs[0];
+    if (cut.num_subgraphs() != 0 || cut.num_atoms() != 1)
+        return false;
+
+    return graph.atoms[0] == cut.atoms[0];
+}
+
+std::vector<RuleStep> rule_steps(const AEGraph& graph) {
+    std::vector<RuleStep> steps;
+    for (auto& where : graph.possible_double_cuts())
+        steps.push_back({"DC", where});
+    for (auto& where : graph.possible_deiterations())
+        steps.push_back({"DE", where});
+    for (auto& where : graph.possible_erasures())
+        steps.push_back({"E", where});
+    return steps;
+}
+
+std::vector<RuleStep> find_proof(AEGraph graph) {
+    // depth first, with an explicit stack; every rule makes the graph
+    // smaller, so the search ends. A graph that was searched without
+    // success fails again wherever it shows up, so it is skipped.
+    struct Frame {
+        AEGraph graph;
+        std::vector<RuleStep> steps;
+        size_t next;
+    };
+
+    graph.sort();
+    if (is_contradiction(graph))
+        return {{"END", {}}};
+
+    std::unordered_set<std::string> failed;
+    std::vector<Frame> stack;
+    stack.push_back({graph, rule_steps(graph), 0});
+
+    while (!stack.empty()) {
+        Frame &top = stack.back();
+        if (top.next == top.steps.size()) {
+            failed.insert(top.graph.repr());
+            stack.pop_back();
+            continue;
+        }
+
+        AEGraph next = top.graph.apply_step(top.steps[top.next++]);
+        if (is_contradiction(next)) {
+            std::vector<RuleStep> proof;
+            for (const auto& frame : stack)
+                proof.push_back(frame.steps[frame.next - 1]);
+            proof.push_back({"END", {}});
+            return proof;
+        }
+
+        if (!failed.count(next.repr())) {
+            auto steps = rule_steps(next);
+            stack.push_back({std::move(next), std::move(steps), 0});
+        }
+    }
+
+    return {};
+}
+
+Proof::Proof(const AEGraph& conclusion) : conclusion(conclusion) {
+    this->conclusion.renumber();
+    this->conclusion.sort();
+}
+
+std::vector<std::string> atoms_of(const AEGraph& graph) {
+    // the distinct atoms anywhere in <graph>, sorted
+    std::set<std::string> atoms;
+    std::vector<const AEGraph*> stack = {&graph};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back();
+        stack.pop_back();
+
+        atoms.insert(node->atoms.begin(), node->atoms.end());
+        for (const auto& sg : node->subgraphs) {
+            stack.push_back(&sg);
+        }
+    }
+    return std::vector<std::string>(atoms.begin(), atoms.end());
+}
+
+int KnowledgeBase::add(const AEGraph& premise) {
+    int index = sheets.size();
+    sheets.push_back(premise);
+    sheets.back().sort();
+    gone.push_back(false);
+    for (uint64_t id : sheets.back().renumber()) {
+        owner[id] = index;
+    }
+
+    signatures.push_back(atoms_of(premise));
+    for (const auto& atom : signatures.back()) {
+        by_atom[atom].push_back(index);
+    }
+    if (signatures.back().empty())
+        atomless.push_back(index);
+    return index;
+}
+
+bool KnowledgeBase::remove(int index) {
+    if (index < 0 || index >= size() || gone[index])
+        return false;
+    gone[index] = true;
+    return true;
+}
+
+bool KnowledgeBase::removed(int index) const {
+    return gone[index];
+}
+
+int KnowledgeBase::size() const {
+    return sheets.size();
+}
+
+const AEGraph& KnowledgeBase::premise(int index) const {
+    return sheets[index];
+}
+
+const std::vector<std::string>& KnowledgeBase::signature(int index) const {
+    return signatures[index];
+}
+
+std::vector<int> KnowledgeBase::relevant(const AEGraph& conclusion,
+    int hops) const {
+    // a breadth-first walk over atoms and the premises that mention them;
+    // every round adds the premises reached through the atoms of the last
+    std::set<int> selected;
+    for (int index : atomless) {
+        if (!gone[index])
+            selected.insert(index);
+    }
+    std::set<std::string> seen;
+    std::vector<std::string> frontier = atoms_of(conclusion);
+    seen.insert(frontier.begin(), frontier.end());
+
+    for (int round = 0; !frontier.empty(); round++) {
+        std::vector<std::string> next;
+        for (const auto& atom : frontier) {
+            auto it = by_atom.find(atom);
+            if (it == by_atom.end())
+                continue;
+            for (int index : it->second) {
+                if (gone[index] || !selected.insert(index).second)
+                    continue;
+                for (const auto& other : signatures[index]) {
+                    if (seen.insert(other).second)
+                        next.push_back(other);
+                }
+            }
+        }
+
+        if (hops >= 0 && round >= hops)
+            break;
+        frontier = std::move(next);
+    }
+
+    return std::vector<int>(selected.begin(), selected.end());
+}
+
+AEGraph KnowledgeBase::premises(const std::vector<int>& selected) const {
+    AEGraph result("()");
+    for (int index : selected) {
+        result = AEGraph::juxtapose(std::move(result), sheets[index]);
+    }
+    return result;
+}
+
+AEGraph KnowledgeBase::counterset(const AEGraph& conclusion, int hops)
+    const {
+    return AEGraph::counterset(premises(relevant(conclusion, hops)),
+        conclusion);
+}
+
+int KnowledgeBase::prove(const AEGraph& conclusion) {
+    Proof proof(conclusion);
+    proof.premises = relevant(proof.conclusion);
+    search(proof);
+    proofs.push_back(std::move(proof));
+    return proofs.size() - 1;
+}
+
+int KnowledgeBase::num_proofs() const {
+    return proofs.size();
+}
+
+const Proof& KnowledgeBase::proof(int index) const {
+    return proofs[index];
+}
+
+AEGraph KnowledgeBase::counterset_of(const Proof& proof) const {
+    // the ids of the premises and of the conclusion are the same every
+    // time, so the moves of the proof find their nodes in it
+    AEGraph graph = AEGraph::counterset(premises(proof.premises),
+        proof.conclusion);
+    graph.sort();
+    return graph;
+}
+
+void KnowledgeBase::search(Proof &proof) const {
+    AEGraph graph = counterset_of(proof);
+    proof.steps = find_proof(graph);
+    proof.moves.clear();
+    proof.used.clear();
+    proof.kept.clear();
+    if (proof.steps.empty())
+        return;
+
+    for (size_t k = 0; k + 1 < proof.steps.size(); k++) {
+        const RuleStep &step = proof.steps[k];
+        proof.moves.push_back({step.first, graph.node_id(step.second)});
+        graph = graph.apply_step(step);
+    }
+    for (int i = 0; i < graph.size(); i++) {
+        proof.kept.push_back(graph.node_id({i}));
+    }
+
+    // replaying finds the premises the steps use and gives the same steps;
+    // should it fail, the proof is taken to need every premise it was
+    // searched with, so any removal searches it again
+    if (!replay(proof))
+        proof.used = proof.premises;
+}
+
+bool KnowledgeBase::replay(Proof &proof) const {
+    // applies the moves of <proof> by id to the counterset of its premises.
+    // Erasures of nodes that are not there any more (their premise is gone)
+    // are skipped, and elements of premises that were not in the original
+    // counterset are erased at the end; any other move that cannot be
+    // applied fails the replay, which leaves <proof> as it was.
+    AEGraph graph = counterset_of(proof);
+    std::vector<RuleStep> steps;
+    std::vector<std::pair<std::string, uint64_t>> moves;
+    std::set<int> used;
+    auto use = [&](uint64_t id) {
+        auto it = owner.find(id);
+        if (it != owner.end())
+            used.insert(it->second);
+    };
+
+    for (const auto& move : proof.moves) {
+        std::vector<int> where;
+        if (!graph.find_node(move.second, where) || where.empty()) {
+            if (move.first == "E")
+                continue;
+            return false;
+        }
+
+        if (move.first == "DC") {
+            if (!graph.can_double_cut(where))
+                return false;
+            use(move.second);
+        } else if (move.first == "DE") {
+            if (!graph.can_deiterate(where))
+                return false;
+            use(move.second);
+
+            // the first element of the sheet the target is a copy of
+            const AEGraph *parent = &graph;
+            for (size_t k = 0; k + 1 < where.size(); k++)
+                parent = &parent->subgraphs[where[k]];
+            int last = where.back();
+            if (last < parent->num_subgraphs()) {
+                for (const auto& sg : graph.subgraphs) {
+                    if (sg == parent->subgraphs[last]) {
+                        use(sg.id);
+                        break;
+                    }
+                }
+            } else {
+                const std::string &atom =
+                    parent->atoms[last - parent->num_subgraphs()];
+                for (int j = 0; j < graph.num_atoms(); j++) {
+                    if (graph.atoms[j] == atom) {
+                        use(graph.atom_ids[j]);
+                        break;
+                    }
+                }
+            }
+        } else if (!graph.can_erase(where)) {
+            return false;
+        }
+
+        steps.push_back({move.first, where});
+        moves.push_back(move);
+        graph = graph.apply_step(steps.back());
+    }
+
+    std::set<uint64_t> kept(proof.kept.begin(), proof.kept.end());
+    for (int i = 0; i < graph.size(); ) {
+        uint64_t id = graph.node_id({i});
+        if (kept.count(id)) {
+            i++;
+            continue;
+        }
+        steps.push_back({"E", {i}});
+        moves.push_back({"E", id});
+        graph = graph.apply_step(steps.back());
+        i = 0;
+    }
+    if (!is_contradiction(graph))
+        return false;
+
+    for (const auto& node : graph.node_paths()) {
+        use(node.first);
+    }
+
+    steps.push_back({"END", {}});
+    proof.steps = std::move(steps);
+    proof.moves = std::move(moves);
+    proof.used = std::vector<int>(used.begin(), used.end());
+    return true;
+}
+
+int KnowledgeBase::revalidate() {
+    int searches = 0;
+    for (auto& proof : proofs) {
+        auto current = relevant(proof.conclusion);
+        if (current == proof.premises)
+            continue;
+
+        // without a proof, fewer premises cannot give one either
+        bool gained = !std::includes(proof.premises.begin(),
+            proof.premises.end(), current.begin(), current.end());
+        bool kept_used = std::includes(current.begin(), current.end(),
+            proof.used.begin(), proof.used.end());
+        proof.premises = current;
+
+        if (proof.steps.empty() ? !gained : kept_used && replay(proof))
+            continue;
+        search(proof);
+        searches++;
+    }
+    return searches;
+}
@@ -0,0 +1,101 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef KNOWLEDGE_BASE_H_
+#define KNOWLEDGE_BASE_H_
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include "./aegraph.h"
+
+// whether <graph> is a sheet of the form (X, [X]), where the full proof
+// search stops
+bool is_contradiction(const AEGraph& graph);
+
+// the steps the proof search tries from <graph>, in order: the double
+// cuts, the deiterations and the erasures, each in lexicographic order
+std::vector<RuleStep> rule_steps(const AEGraph& graph);
+
+// searches the counterset <graph> for a contradiction with double cuts,
+// deiterations and erasures, tried in that order at sites in lexicographic
+// order; returns the steps of the first proof found, followed by
+// {"END", {}}, or nothing if there is none
+std::vector<RuleStep> find_proof(AEGraph graph);
+
+// a conclusion proved (or not) from the premises of a knowledge base
+struct Proof {
+    explicit Proof(const AEGraph& conclusion);
+
+    // the conclusion, with the ids the moves refer to
+    AEGraph conclusion;
+    // the relevant premises the counterset was built from
+    std::vector<int> premises;
+    // the steps on the sorted counterset, empty if there is no proof, and
+    // the same steps by the id of the node they are applied to
+    std::vector<RuleStep> steps;
+    std::vector<std::pair<std::string, uint64_t>> moves;
+    // the premises the proof cannot do without: those it applies a double
+    // cut or a deiteration to, or that are left in the contradiction; the
+    // premises it only erases are not among them
+    std::vector<int> used;
+    // ids of the elements of the final sheet
+    std::vector<uint64_t> kept;
+};
+
+// Premise sheets kept in canonical form and indexed by the atoms they
+// mention, so a conclusion is proved against the premises that can matter
+// to it instead of against the juxtaposition of all of them.
+class KnowledgeBase {
+ public:
+    // returns the number of the premise, counting from 0
+    int add(const AEGraph& premise);
+    // the other premises keep their numbers
+    bool remove(int index);
+    bool removed(int index) const;
+    int size() const;
+    const AEGraph& premise(int index) const;
+
+    // the distinct atoms of a premise, sorted
+    const std::vector<std::string>& signature(int index) const;
+
+    // the premises that share an atom with the conclusion or, through at
+    // most <hops> further premises (any number if negative), with another
+    // relevant premise; premises without atoms are always relevant
+    std::vector<int> relevant(const AEGraph& conclusion, int hops = -1) const;
+
+    // the juxtaposition of the given premises
+    AEGraph premises(const std::vector<int>& selected) const;
+    // the relevant premises together with the negated conclusion
+    AEGraph counterset(const AEGraph& conclusion, int hops = -1) const;
+
+    // proves <conclusion> from its relevant premises and keeps the proof;
+    // returns its number
+    int prove(const AEGraph& conclusion);
+    int num_proofs() const;
+    const Proof& proof(int index) const;
+
+    // brings the kept proofs up to date after premises were added or
+    // removed: a proof whose used premises are all still there is replayed
+    // by node id on the new counterset, and only the others are searched
+    // again; returns how many searches were run
+    int revalidate();
+
+ private:
+    AEGraph counterset_of(const Proof& proof) const;
+    bool replay(Proof &proof) const;
+    void search(Proof &proof) const;
+
+    std::vector<AEGraph> sheets;
+    std::vector<std::vector<std::string>> signatures;
+    // for every atom, the premises that mention it
+    std::map<std::string, std::vector<int>> by_atom;
+    std::vector<int> atomless;
+    std::vector<bool> gone;
+    // the premise every node and atom id of the premises comes from
+    std::unordered_map<uint64_t, int> owner;
+    std::vector<Proof> proofs;
+};
+
+#endif  // KNOWLEDGE_BASE_H_
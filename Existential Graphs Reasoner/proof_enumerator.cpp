@@ -0,0 +1,196 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <unordered_set>
+#include "./proof_enumerator.h"
+#include "./knowledge_base.h"
+
+ProofEnumerator::ProofEnumerator(AEGraph graph, bool shortest_first)
+    : shortest_first(shortest_first), found(0), trivial(false), longest(0),
+      length(0), ending(0) {
+    graph.sort();
+    if (is_contradiction(graph)) {
+        trivial = true;
+    } else if (shortest_first) {
+        nodes.push_back({0, graph.total_size(), {}});
+        seen.emplace(graph.repr(), 0);
+        queue.push_back({std::move(graph), 0});
+    } else {
+        auto steps = rule_steps(graph);
+        stack.push_back({std::move(graph), std::move(steps), 0, {}, false});
+    }
+}
+
+bool ProofEnumerator::next(std::vector<RuleStep> &proof) {
+    proof.clear();
+    bool ok;
+    if (trivial) {
+        trivial = false;
+        ok = true;
+    } else {
+        ok = shortest_first ? shortest(proof) : depth_first(proof);
+    }
+    if (!ok)
+        return false;
+
+    proof.push_back({"END", {}});
+    found++;
+    return true;
+}
+
+bool ProofEnumerator::depth_first(std::vector<RuleStep> &proof) {
+    while (!stack.empty()) {
+        Frame &top = stack.back();
+        if (top.next == top.steps.size()) {
+            // the graphs a proof went through are searched again when
+            // they show up after other steps, for the proofs they give
+            bool proved = top.proved;
+            if (!proved)
+                failed.insert(top.graph.repr());
+            stack.pop_back();
+            if (proved && !stack.empty())
+                stack.back().proved = true;
+            continue;
+        }
+
+        AEGraph next = top.graph.apply_step(top.steps[top.next++]);
+        std::string repr = next.repr();
+        if (!top.children.insert(repr).second)
+            continue;
+
+        if (is_contradiction(next)) {
+            top.proved = true;
+            for (const auto& frame : stack)
+                proof.push_back(frame.steps[frame.next - 1]);
+            return true;
+        }
+
+        if (!failed.count(repr)) {
+            auto steps = rule_steps(next);
+            stack.push_back({std::move(next), std::move(steps), 0, {},
+                false});
+        }
+    }
+    return false;
+}
+
+bool ProofEnumerator::shortest(std::vector<RuleStep> &proof) {
+    // the proofs of a length are listed once every graph they can go
+    // through is expanded, that is every graph fewer steps away from the
+    // counterset; the graphs leave the queue in order of depth
+    while (!next_route(proof)) {
+        length++;
+        ending = 0;
+        while (!queue.empty() &&
+               nodes[queue.front().second].depth < length)
+            expand();
+        if (queue.empty() && length > longest)
+            return false;
+    }
+    return true;
+}
+
+void ProofEnumerator::expand() {
+    // tries the steps of the graph at the front of the queue; a graph
+    // that was already reached only gets one more way to reach it
+    AEGraph graph = std::move(queue.front().first);
+    int node = queue.front().second;
+    queue.pop_front();
+
+    std::unordered_set<std::string> children;
+    for (const auto& step : rule_steps(graph)) {
+        AEGraph next = graph.apply_step(step);
+        std::string repr = next.repr();
+        if (!children.insert(repr).second)
+            continue;
+
+        if (is_contradiction(next)) {
+            endings.push_back({step, node});
+            // a proof has at most one step per element removed
+            longest = std::max(longest,
+                nodes[0].size - nodes[node].size + 1);
+            continue;
+        }
+
+        auto known = seen.find(repr);
+        if (known != seen.end()) {
+            nodes[known->second].parents.push_back({step, node});
+            continue;
+        }
+        seen.emplace(std::move(repr), nodes.size());
+        nodes.push_back({nodes[node].depth + 1, next.total_size(),
+            {{step, node}}});
+        queue.push_back({std::move(next), static_cast<int>(nodes.size()) - 1});
+    }
+}
+
+bool ProofEnumerator::reachable(int node, int steps) const {
+    // whether a path of exactly <steps> steps may lead to <node> from the
+    // counterset: not fewer than its depth, and not more than the elements
+    // that are gone
+    return steps >= nodes[node].depth &&
+        steps <= nodes[0].size - nodes[node].size;
+}
+
+bool ProofEnumerator::next_route(std::vector<RuleStep> &proof) {
+    // the next proof of <length> steps, depth first over the parents of
+    // the node each ending is taken from, back to the counterset
+    while (ending < endings.size()) {
+        if (trail.empty()) {
+            int node = endings[ending].second;
+            if (!reachable(node, length - 1)) {
+                ending++;
+                continue;
+            }
+            trail.push_back({node, 0});
+        }
+
+        while (!trail.empty()) {
+            int node = trail.back().first;
+            if (node == 0) {
+                // only reachable in no steps, so the path is complete
+                for (size_t k = trail.size() - 1; k-- > 0;) {
+                    const Node &on = nodes[trail[k].first];
+                    proof.push_back(on.parents[trail[k].second - 1].first);
+                }
+                proof.push_back(endings[ending].first);
+                trail.pop_back();
+                if (trail.empty())
+                    ending++;
+                return true;
+            }
+
+            // the steps still missing before this node
+            int left = length - trail.size();
+            const auto &parents = nodes[node].parents;
+            size_t &i = trail.back().second;
+            while (i < parents.size() &&
+                   !reachable(parents[i].second, left - 1))
+                i++;
+            if (i == parents.size()) {
+                trail.pop_back();
+                continue;
+            }
+            trail.push_back({parents[i++].second, 0});
+        }
+        ending++;
+    }
+    return false;
+}
+
+int ProofEnumerator::count() const {
+    return found;
+}
+
+std::vector<std::vector<RuleStep>> shortest_proofs(const AEGraph& graph,
+    int k) {
+    std::vector<std::vector<RuleStep>> proofs;
+    ProofEnumerator enumerator(graph, true);
+    std::vector<RuleStep> proof;
+    while (static_cast<int>(proofs.size()) < k && enumerator.next(proof)) {
+        proofs.push_back(proof);
+    }
+    return proofs;
+}
@@ -0,0 +1,92 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef PROOF_ENUMERATOR_H_
+#define PROOF_ENUMERATOR_H_
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <utility>
+#include <unordered_set>
+#include <unordered_map>
+#include "./aegraph.h"
+
+// Lists the proofs of a counterset one at a time, keeping the state of the
+// search between calls, so that asking for a few proofs costs no more than
+// finding them. Every proof ends with {"END", {}} at its first
+// contradiction. Two steps from the same graph that give equal graphs lead
+// to the same proofs, so only the first of them is followed; the proofs
+// listed are then distinct as sequences of graphs.
+class ProofEnumerator {
+ public:
+    // depth first, in the order find_proof() tries the steps, so the first
+    // proof is the one find_proof() returns; or, if <shortest_first>,
+    // breadth first, from the shortest proofs to the longest, which keeps
+    // every graph of the current depth in memory. Breadth first, a graph
+    // that several partial proofs reach is expanded once; the proofs are
+    // then the paths through the steps between distinct graphs.
+    explicit ProofEnumerator(AEGraph graph, bool shortest_first = false);
+
+    // false when there are no more proofs
+    bool next(std::vector<RuleStep> &proof);
+    // how many proofs were listed
+    int count() const;
+
+ private:
+    // depth first: a graph whose steps are being tried
+    struct Frame {
+        AEGraph graph;
+        std::vector<RuleStep> steps;
+        size_t next;
+        // the graphs the tried steps gave
+        std::unordered_set<std::string> children;
+        // whether a proof goes through the graph
+        bool proved;
+    };
+
+    // breadth first: a distinct graph, with the steps that lead to it
+    struct Node {
+        // the fewest steps from the counterset, and the size of the graph,
+        // which every step makes smaller
+        int depth;
+        int size;
+        std::vector<std::pair<RuleStep, int>> parents;
+    };
+
+    bool depth_first(std::vector<RuleStep> &proof);
+    bool shortest(std::vector<RuleStep> &proof);
+    void expand();
+    bool reachable(int node, int steps) const;
+    bool next_route(std::vector<RuleStep> &proof);
+
+    bool shortest_first;
+    int found;
+    // the counterset is already a contradiction, and its proof is pending
+    bool trivial;
+
+    // depth first: the path to the current graph, and the graphs the
+    // search went through without a proof
+    std::vector<Frame> stack;
+    std::unordered_set<std::string> failed;
+
+    // breadth first: the graphs by their repr (the counterset is node 0),
+    // the ones waiting to be expanded, and the steps that end in a
+    // contradiction, each with the node it is taken from
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, int> seen;
+    std::deque<std::pair<AEGraph, int>> queue;
+    std::vector<std::pair<RuleStep, int>> endings;
+    // an upper bound on the length of a proof that is not listed yet
+    int longest;
+    // the proofs of <length> steps (besides END) are being listed: the
+    // one that ends with endings[ending], along the nodes of <trail>, each
+    // with the next of its parents to try
+    int length;
+    size_t ending;
+    std::vector<std::pair<int, size_t>> trail;
+};
+
+// the (at most) <k> shortest proofs of the counterset <graph>
+std::vector<std::vector<RuleStep>> shortest_proofs(const AEGraph& graph,
+    int k);
+
+#endif  // PROOF_ENUMERATOR_H_
@@ -0,0 +1,74 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "./proof_replay.h"
+#include "./knowledge_base.h"
+
+ProofReplay::ProofReplay(const AEGraph& premise, std::vector<RuleStep> steps,
+    int snapshot_interval)
+    : g(premise), steps(std::move(steps)),
+      interval(snapshot_interval > 0 ? snapshot_interval : 1), current(0) {
+    g.sort();
+    snapshots.push_back(g);
+}
+
+bool ProofReplay::step() {
+    if (current == size())
+        return false;
+
+    const RuleStep &next = steps[current];
+    const std::vector<int> &where = next.second;
+    if (next.first == "DC" && g.can_double_cut(where)) {
+        g.double_cut_helper(where, g);
+    } else if (next.first == "E" && g.can_erase(where)) {
+        g.erase_helper(where, g);
+    } else if (next.first == "DE" && g.can_deiterate(where)) {
+        g.deiterate_helper(where, g);
+    } else if (next.first != "END" || !is_contradiction(g)) {
+        return false;
+    }
+
+    current++;
+    if (current % interval == 0 &&
+        static_cast<int>(snapshots.size()) == current / interval) {
+        snapshots.push_back(g);
+    }
+    return true;
+}
+
+bool ProofReplay::seek(int k) {
+    if (k < 0 || k > size())
+        return false;
+
+    // the closest snapshot at or before <k>, unless going on from the
+    // current graph is shorter
+    int snapshot = std::min<int>(k / interval, snapshots.size() - 1);
+    if (current > k || snapshot * interval > current) {
+        g = snapshots[snapshot];
+        current = snapshot * interval;
+    }
+    while (current < k) {
+        if (!step())
+            return false;
+    }
+    return true;
+}
+
+int ProofReplay::validate() {
+    if (!seek(size()))
+        return current;
+    return -1;
+}
+
+int ProofReplay::position() const {
+    return current;
+}
+
+int ProofReplay::size() const {
+    return steps.size();
+}
+
+const AEGraph& ProofReplay::graph() const {
+    return g;
+}
@@ -0,0 +1,42 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef PROOF_REPLAY_H_
+#define PROOF_REPLAY_H_
+
+#include <vector>
+#include "./aegraph.h"
+
+// Replays the steps of a proof on a single graph. A step is checked with
+// the can_* predicates, which look at its own path instead of listing
+// every site, and is applied in place by the rule helpers, which keep the
+// graph sorted and its cached sums up to date. A copy of the graph is kept
+// every <snapshot_interval> steps, so seek() only has to replay the steps
+// after the closest one.
+class ProofReplay {
+ public:
+    ProofReplay(const AEGraph& premise, std::vector<RuleStep> steps,
+        int snapshot_interval = 64);
+
+    // applies the next step; false, with nothing changed, if it is not
+    // legal or there is none ("END" is legal on a contradiction)
+    bool step();
+    // the graph after the first <k> steps; false if a step on the way is
+    // not legal, which is where the replay stops
+    bool seek(int k);
+    // replays the whole proof; returns the number of the first step that
+    // is not legal, or -1 if there is none
+    int validate();
+
+    int position() const;
+    int size() const;
+    const AEGraph& graph() const;
+
+ private:
+    AEGraph g;
+    std::vector<RuleStep> steps;
+    int interval;
+    int current;
+    // snapshots[i] is the graph after i * interval steps
+    std::vector<AEGraph> snapshots;
+};
+
+#endif  // PROOF_REPLAY_H_
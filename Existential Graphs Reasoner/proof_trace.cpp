@@ -0,0 +1,248 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <string>
+#include <functional>
+#include "./proof_trace.h"
+
+// the rules in the low bits of a tag byte
+const char *const rule_names[] = {"DC", "DE", "E", "END"};
+const int keyframe_tag = 4;
+const int long_prefix = 31;
+
+void put_varint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+bool get_varint(const unsigned char *&p, const unsigned char *end,
+    uint64_t &value) {
+    // false if the varint runs past <end> or past 64 bits
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        value |= static_cast<uint64_t>(*p & 0x7f) << shift;
+        if (!(*p++ & 0x80))
+            return true;
+    }
+    return false;
+}
+
+TraceWriter::TraceWriter(const AEGraph& start, int keyframe_interval)
+    : out("AEGT\x01"), graph(start), interval(keyframe_interval),
+      steps(0) {
+    keyframe(start);
+    // the graph is only followed when there are more keyframes to write
+    if (interval <= 0)
+        graph = AEGraph("()");
+}
+
+void TraceWriter::keyframe(const AEGraph& graph) {
+    std::string text = graph.repr();
+    out += static_cast<char>(keyframe_tag);
+    put_varint(out, text.size());
+    out += text;
+    previous.clear();
+}
+
+void TraceWriter::add(const RuleStep& step) {
+    if (interval > 0 && steps > 0 && steps % interval == 0)
+        keyframe(graph);
+
+    int rule = 0;
+    while (rule < 4 && step.first != rule_names[rule])
+        rule++;
+    assert(rule < 4);
+
+    const std::vector<int> &path = step.second;
+    size_t common = 0;
+    while (common < path.size() && common < previous.size() &&
+           path[common] == previous[common])
+        common++;
+
+    if (common < long_prefix) {
+        out += static_cast<char>(rule | common << 3);
+    } else {
+        out += static_cast<char>(rule | long_prefix << 3);
+        put_varint(out, common);
+    }
+    put_varint(out, path.size() - common);
+    for (size_t k = common; k < path.size(); k++) {
+        int64_t value = path[k];
+        if (k == common && k < previous.size()) {
+            int64_t change = value - previous[k];
+            put_varint(out, (static_cast<uint64_t>(change) << 1) ^
+                static_cast<uint64_t>(change >> 63));
+        } else {
+            put_varint(out, value);
+        }
+    }
+    previous = path;
+
+    if (interval > 0 && rule < 3)
+        graph = graph.apply_step(step);
+    steps++;
+}
+
+int TraceWriter::size() const {
+    return steps;
+}
+
+const std::string& TraceWriter::data() const {
+    return out;
+}
+
+TraceReader::TraceReader(const char *data, size_t size)
+    : p(reinterpret_cast<const unsigned char*>(data)), end(p + size),
+      steps(0), frame(nullptr), frame_size(0), frame_position(-1),
+      malformed(false) {
+    if (size < 5 || std::string(data, 5) != std::string("AEGT\x01", 5)) {
+        malformed = true;
+        p = end;
+        return;
+    }
+    p += 5;
+}
+
+TraceReader::TraceReader(const std::string& data)
+    : TraceReader(data.data(), data.size()) {
+}
+
+bool TraceReader::next(RuleStep &step) {
+    if (malformed)
+        return false;
+    // the reader stops for good at the first record that does not decode
+    malformed = true;
+
+    uint64_t value;
+    while (p < end && (*p & 7) == keyframe_tag) {
+        p++;
+        if (!get_varint(p, end, value) ||
+            static_cast<uint64_t>(end - p) < value)
+            return false;
+        frame_size = value;
+        frame = reinterpret_cast<const char*>(p);
+        frame_position = steps;
+        p += frame_size;
+        previous.clear();
+    }
+    if (p == end) {
+        malformed = false;
+        return false;
+    }
+    // a step is always preceded by a keyframe
+    if (!frame)
+        return false;
+
+    int rule = *p & 7;
+    uint64_t common = *p++ >> 3;
+    if (rule >= 4)
+        return false;
+    if (common == long_prefix && !get_varint(p, end, common))
+        return false;
+    if (common > previous.size())
+        return false;
+
+    // every index takes at least one byte
+    uint64_t changed;
+    if (!get_varint(p, end, changed) ||
+        changed > static_cast<uint64_t>(end - p))
+        return false;
+    // the indices are ints that are not negative; a value or a change
+    // that leaves that range is bad data, not a step
+    const int64_t largest = std::numeric_limits<int>::max();
+    size_t old_size = previous.size();
+    previous.resize(common + changed);
+    for (size_t k = common; k < previous.size(); k++) {
+        if (!get_varint(p, end, value))
+            return false;
+        if (k == common && k < old_size) {
+            int64_t change = static_cast<int64_t>(value >> 1) ^
+                -static_cast<int64_t>(value & 1);
+            if (change < -previous[k] || change > largest - previous[k])
+                return false;
+            previous[k] += change;
+        } else {
+            if (value > static_cast<uint64_t>(largest))
+                return false;
+            previous[k] = value;
+        }
+    }
+    step.first = rule_names[rule];
+    step.second = previous;
+    steps++;
+    malformed = false;
+    return true;
+}
+
+bool TraceReader::failed() const {
+    return malformed;
+}
+
+int TraceReader::position() const {
+    return steps;
+}
+
+AEGraph TraceReader::keyframe() const {
+    assert(frame);
+    return AEGraph(std::string(frame, frame_size));
+}
+
+int TraceReader::keyframe_position() const {
+    return frame_position;
+}
+
+std::string encode_trace(const AEGraph& start,
+    const std::vector<RuleStep>& steps, int keyframe_interval) {
+    TraceWriter writer(start, keyframe_interval);
+    for (const auto& step : steps) {
+        writer.add(step);
+    }
+    return writer.data();
+}
+
+std::vector<RuleStep> decode_trace(const std::string& data) {
+    std::vector<RuleStep> steps;
+    TraceReader reader(data);
+    RuleStep step;
+    while (reader.next(step)) {
+        steps.push_back(step);
+    }
+    return steps;
+}
+
+void replay_trace(const std::string& data, int begin, int end,
+    std::function<void(int, const RuleStep&, const AEGraph&)> visit) {
+    TraceReader reader(data);
+    RuleStep step;
+    // the steps read since the last keyframe, while looking for <begin>
+    std::vector<RuleStep> pending;
+    int frame = -1;
+    AEGraph graph("()");
+
+    while (reader.position() < end && reader.next(step)) {
+        int index = reader.position() - 1;
+        if (index <= begin && reader.keyframe_position() != frame) {
+            frame = reader.keyframe_position();
+            pending.clear();
+        }
+        if (index < begin) {
+            pending.push_back(step);
+            continue;
+        }
+
+        if (index == begin) {
+            graph = reader.keyframe();
+            for (const auto& done : pending) {
+                graph = graph.apply_step(done);
+            }
+        }
+        visit(index, step, graph);
+        if (step.first != "END")
+            graph = graph.apply_step(step);
+    }
+}
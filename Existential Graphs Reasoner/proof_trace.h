@@ -0,0 +1,82 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef PROOF_TRACE_H_
+#define PROOF_TRACE_H_
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <functional>
+#include "./aegraph.h"
+
+// A compact binary form of a proof. After the 5 byte header ("AEGT" and
+// the version) every step is one record: a tag byte that holds the rule
+// in its low 3 bits and, in the other 5, how many leading indices the
+// path shares with the previous one (31 means the count follows as a
+// varint), then the number of indices that differ and the indices
+// themselves as varints, the first one as the zigzag coded change from
+// the previous path. A keyframe record holds the text of the graph the
+// next step is applied to and restarts the paths from nothing; there is
+// always one before the first step, so any range of steps can be replayed
+// from the keyframe before it.
+class TraceWriter {
+ public:
+    // a keyframe is written every <keyframe_interval> steps (0 for only the
+    // first one); keyframes after the first need the steps to be applied
+    explicit TraceWriter(const AEGraph& start, int keyframe_interval = 0);
+
+    void add(const RuleStep& step);
+    int size() const;
+    const std::string& data() const;
+
+ private:
+    void keyframe(const AEGraph& graph);
+
+    std::string out;
+    std::vector<int> previous;
+    AEGraph graph;
+    int interval;
+    int steps;
+};
+
+// reads the steps of a trace one at a time, without decoding keyframes
+// that are not asked for
+class TraceReader {
+ public:
+    TraceReader(const char *data, size_t size);
+    explicit TraceReader(const std::string& data);
+
+    // false at the end of the trace, and from the first record that is
+    // malformed or cut short on; an index that does not fit a
+    // non-negative int, given directly or as a change, is malformed
+    bool next(RuleStep &step);
+    // whether the reading stopped at bad data rather than at the end
+    bool failed() const;
+    // how many steps were read
+    int position() const;
+
+    // the last keyframe read, and the number of the step it comes before
+    AEGraph keyframe() const;
+    int keyframe_position() const;
+
+ private:
+    const unsigned char *p, *end;
+    std::vector<int> previous;
+    int steps;
+    const char *frame;
+    size_t frame_size;
+    int frame_position;
+    bool malformed;
+};
+
+std::string encode_trace(const AEGraph& start,
+    const std::vector<RuleStep>& steps, int keyframe_interval = 0);
+// the steps before the first malformed record, if there is one
+std::vector<RuleStep> decode_trace(const std::string& data);
+
+// calls visit(number, step, graph) for the steps numbered from <begin> up
+// to <end>, with the graph each one is applied to; only the steps after
+// the last keyframe before <begin> are applied to get there
+void replay_trace(const std::string& data, int begin, int end,
+    std::function<void(int, const RuleStep&, const AEGraph&)> visit);
+
+#endif  // PROOF_TRACE_H_
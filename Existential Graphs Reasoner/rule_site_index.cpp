@@ -0,0 +1,410 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include "./rule_site_index.h"
+
+RuleSiteIndex::RuleSiteIndex(AEGraph &graph) : g(graph) {
+    for (const auto& sg : g.subgraphs) {
+        change_root(sg.hash(), sg.label(), 1);
+    }
+    for (const auto& atom : g.atoms) {
+        change_root(atom_hash(atom), atom, 1);
+    }
+
+    // post-order, so the subgraphs of a cut are indexed before it
+    areas[g.id] = Area{0, false, {}, 0};
+    std::vector<std::pair<const AEGraph*, bool>> stack = {{&g, false}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        if (stack.back().second) {
+            stack.pop_back();
+            index_area(*node);
+            continue;
+        }
+
+        stack.back().second = true;
+        for (const auto& sg : node->subgraphs) {
+            areas[sg.id] = Area{node->id, false, {}, 0};
+            stack.push_back({&sg, false});
+        }
+    }
+}
+
+const AEGraph& RuleSiteIndex::graph() const {
+    return g;
+}
+
+int RuleSiteIndex::count_originals(uint64_t hash) const {
+    auto it = roots.find(hash);
+    return it == roots.end() ? 0 : it->second.size();
+}
+
+void RuleSiteIndex::index_area(const AEGraph& node) {
+    // recomputes what the index keeps for a single cut from its elements
+    // and from what it keeps for the subgraphs; costs as much as the cut's
+    // own elements
+    Area &area = areas.at(node.id);
+    for (uint64_t hash : area.candidates) {
+        auto it = holders.find(hash);
+        if (--it->second[node.id] == 0)
+            it->second.erase(node.id);
+        if (it->second.empty())
+            holders.erase(it);
+    }
+
+    area.candidates.clear();
+    if (node.id != g.id && node.size() > 1) {
+        for (const auto& sg : node.subgraphs) {
+            area.candidates.push_back(sg.hash());
+        }
+        for (const auto& atom : node.atoms) {
+            area.candidates.push_back(atom_hash(atom));
+        }
+    }
+
+    area.originals = 0;
+    for (uint64_t hash : area.candidates) {
+        holders[hash][node.id]++;
+        area.originals += count_originals(hash);
+    }
+    for (const auto& sg : node.subgraphs) {
+        area.originals += areas.at(sg.id).originals;
+    }
+}
+
+void RuleSiteIndex::change_root(uint64_t hash, const std::string& label,
+    int delta) {
+    // adds (delta 1) or removes (delta -1) an element of the sheet of
+    // assertion; a label of a subgraph starts with a bracket, so it never
+    // equals the name of an atom
+    std::vector<std::string> &labels = roots[hash];
+    if (delta > 0) {
+        labels.insert(std::upper_bound(labels.begin(), labels.end(), label),
+            label);
+    } else {
+        labels.erase(std::lower_bound(labels.begin(), labels.end(), label));
+    }
+    if (labels.empty())
+        roots.erase(hash);
+
+    // the candidates with this hash gained or lost an original
+    auto it = holders.find(hash);
+    if (it == holders.end())
+        return;
+    for (const auto& holder : it->second) {
+        propagate(holder.first, holder.second * delta);
+    }
+}
+
+void RuleSiteIndex::propagate(uint64_t id, int delta) {
+    // up to the sheet, or to the top of a subtree a rule took out
+    while (true) {
+        Area &area = areas.at(id);
+        area.originals += delta;
+        if (area.detached || id == g.id)
+            break;
+        id = area.parent;
+    }
+}
+
+std::vector<std::vector<int>> RuleSiteIndex::possible_double_cuts() const {
+    // a cut is listed before the sites inside it; only the subgraphs whose
+    // cached counts show sites are entered
+    std::vector<std::vector<int>> road;
+    std::vector<int> path;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&g, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        if (i >= node->num_subgraphs()) {
+            stack.pop_back();
+            if (!path.empty())
+                path.pop_back();
+            continue;
+        }
+
+        const AEGraph &sg = node->subgraphs[i];
+        path.push_back(i);
+        if (sg.num_subgraphs() == 1 && sg.num_atoms() == 0)
+            road.push_back(path);
+        if (sg.count_double_cuts() > 0) {
+            stack.push_back({&sg, 0});
+        } else {
+            path.pop_back();
+        }
+    }
+    return road;
+}
+
+std::vector<std::vector<int>> RuleSiteIndex::possible_erasures() const {
+    // like possible_double_cuts(); the level of an area is the length of
+    // its path minus one
+    std::vector<std::vector<int>> road;
+    std::vector<int> path;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&g, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        int level = static_cast<int>(path.size()) - 1;
+        bool own = level % 2 != 0 && !(level != -1 && node->size() == 1);
+        if (i >= (own ? node->size() : node->num_subgraphs())) {
+            stack.pop_back();
+            if (!path.empty())
+                path.pop_back();
+            continue;
+        }
+
+        path.push_back(i);
+        if (own)
+            road.push_back(path);
+        if (i < node->num_subgraphs() &&
+            node->subgraphs[i].count_erasures(level + 1) > 0) {
+            stack.push_back({&node->subgraphs[i], 0});
+        } else {
+            path.pop_back();
+        }
+    }
+    return road;
+}
+
+std::vector<std::vector<int>> RuleSiteIndex::possible_deiterations() const {
+    // an element inside a subgraph of the sheet of assertion is listed once
+    // for every equal element on the sheet itself; equal hashes are
+    // confirmed by the labels, and only the subgraphs with candidates that
+    // have originals are entered
+    std::vector<std::vector<int>> road;
+    std::vector<int> path;
+    std::vector<std::pair<const AEGraph*, int>> stack = {{&g, 0}};
+    while (!stack.empty()) {
+        const AEGraph *node = stack.back().first;
+        int i = stack.back().second++;
+        bool candidates = node != &g && node->size() > 1;
+        if (i >= (candidates ? node->size() : node->num_subgraphs())) {
+            stack.pop_back();
+            if (!path.empty())
+                path.pop_back();
+            continue;
+        }
+
+        path.push_back(i);
+        if (i < node->num_subgraphs()) {
+            const AEGraph &sg = node->subgraphs[i];
+            if (candidates && count_originals(sg.hash()) > 0) {
+                const auto &labels = roots.at(sg.hash());
+                auto range = std::equal_range(labels.begin(), labels.end(),
+                    sg.label());
+                road.insert(road.end(), range.second - range.first, path);
+            }
+            if (areas.at(sg.id).originals > 0) {
+                stack.push_back({&sg, 0});
+                continue;
+            }
+        } else {
+            const std::string &atom = node->atoms[i - node->num_subgraphs()];
+            if (count_originals(atom_hash(atom)) > 0) {
+                const auto &labels = roots.at(atom_hash(atom));
+                auto range = std::equal_range(labels.begin(), labels.end(),
+                    atom);
+                road.insert(road.end(), range.second - range.first, path);
+            }
+        }
+        path.pop_back();
+    }
+    return road;
+}
+
+std::vector<int> RuleSiteIndex::path_to(uint64_t id) const {
+    // the ancestors of the cut by their ids, then their positions from the
+    // sheet of assertion down
+    std::vector<uint64_t> ids;
+    for (; id != g.id; id = areas.at(id).parent) {
+        ids.push_back(id);
+    }
+
+    std::vector<int> path;
+    const AEGraph *node = &g;
+    for (auto it = ids.rbegin(); it != ids.rend(); ++it) {
+        int i = 0;
+        while (node->subgraphs[i].id != *it)
+            i++;
+        path.push_back(i);
+        node = &node->subgraphs[i];
+    }
+    return path;
+}
+
+void RuleSiteIndex::edit(const std::vector<int>& area,
+    std::function<void(AEGraph&)> change) {
+    // edits the area at <area> in place, then fixes the hashes and the
+    // canonical order of its ancestors and what the index keeps for them.
+    // A change below the sheet of assertion
+    // replaces one of its elements; <change> reports its own changes to the
+    // elements of the sheet.
+    std::vector<AEGraph*> nodes = {&g};
+    std::vector<AEGraph::Contribution> old = {g.contribution()};
+    for (int index : area) {
+        nodes.push_back(&nodes.back()->subgraphs[index]);
+        old.push_back(nodes.back()->contribution());
+    }
+
+    if (!area.empty())
+        change_root(nodes[1]->hash(), nodes[1]->label(), -1);
+    change(*nodes.back());
+
+    std::vector<int> new_area = area;
+    for (size_t k = area.size(); k > 0; k--) {
+        nodes[k - 1]->update_child(old[k], nodes[k]->contribution());
+        new_area[k - 1] = nodes[k - 1]->reposition(area[k - 1]);
+    }
+
+    // the subgraphs moved, so the path is walked again
+    nodes.assign(1, &g);
+    for (int index : new_area) {
+        nodes.push_back(&nodes.back()->subgraphs[index]);
+    }
+    if (!area.empty())
+        change_root(nodes[1]->hash(), nodes[1]->label(), 1);
+    for (size_t k = nodes.size(); k > 0; k--) {
+        index_area(*nodes[k - 1]);
+    }
+}
+
+void RuleSiteIndex::double_cut(std::vector<int> where) {
+    // the elements of the inner cut are moved up, not copied, and the
+    // emptied cut is kept for undo()
+    Change change;
+    change.rule = "DC";
+    int index = where.back();
+    where.pop_back();
+
+    edit(where, [&](AEGraph &node) {
+        bool sheet = &node == &g;
+        change.area = node.id;
+        AEGraph cut = node.take_subgraph(index);
+        areas.at(cut.id).detached = true;
+        if (sheet)
+            change_root(cut.hash(), cut.label(), -1);
+
+        AEGraph &inner = cut.subgraphs[0];
+        AEGraph::Contribution before = inner.contribution();
+        while (inner.num_subgraphs() > 0) {
+            AEGraph sg = inner.take_subgraph(inner.num_subgraphs() - 1);
+            areas.at(sg.id).parent = node.id;
+            change.moved_subgraphs.push_back(sg.id);
+            if (sheet)
+                change_root(sg.hash(), sg.label(), 1);
+            node.insert_subgraph(std::move(sg));
+        }
+        while (inner.num_atoms() > 0) {
+            int i = inner.num_atoms() - 1;
+            std::string atom = inner.atoms[i];
+            uint64_t atom_id = inner.atom_ids[i];
+            inner.remove_atom(i);
+            change.moved_atoms.push_back(atom_id);
+            if (sheet)
+                change_root(atom_hash(atom), atom, 1);
+            node.insert_atom(std::move(atom), atom_id);
+        }
+        cut.update_child(before, inner.contribution());
+        index_area(inner);
+        index_area(cut);
+        change.removed_subgraphs.push_back(std::move(cut));
+    });
+
+    history.push_back(std::move(change));
+}
+
+void RuleSiteIndex::erase(std::vector<int> where) {
+    Change change;
+    change.rule = "E";
+    int index = where.back();
+    where.pop_back();
+
+    edit(where, [&](AEGraph &node) {
+        bool sheet = &node == &g;
+        change.area = node.id;
+        if (index < node.num_subgraphs()) {
+            AEGraph sg = node.take_subgraph(index);
+            areas.at(sg.id).detached = true;
+            if (sheet)
+                change_root(sg.hash(), sg.label(), -1);
+            change.removed_subgraphs.push_back(std::move(sg));
+        } else {
+            int i = index - node.num_subgraphs();
+            if (sheet)
+                change_root(atom_hash(node.atoms[i]), node.atoms[i], -1);
+            change.removed_atoms.push_back(node.atoms[i]);
+            change.removed_atom_ids.push_back(node.atom_ids[i]);
+            node.remove_atom(i);
+        }
+    });
+
+    history.push_back(std::move(change));
+}
+
+void RuleSiteIndex::deiterate(std::vector<int> where) {
+    // structurally the same edit as an erasure
+    erase(where);
+    history.back().rule = "DE";
+}
+
+bool RuleSiteIndex::undo() {
+    if (history.empty())
+        return false;
+
+    Change change = std::move(history.back());
+    history.pop_back();
+
+    edit(path_to(change.area), [&](AEGraph &node) {
+        bool sheet = &node == &g;
+        if (change.rule == "DC") {
+            // put the hoisted elements back into the inner cut
+            AEGraph &cut = change.removed_subgraphs[0];
+            AEGraph &inner = cut.subgraphs[0];
+            AEGraph::Contribution before = inner.contribution();
+            for (uint64_t id : change.moved_subgraphs) {
+                int i = 0;
+                while (node.subgraphs[i].id != id)
+                    i++;
+                AEGraph sg = node.take_subgraph(i);
+                if (sheet)
+                    change_root(sg.hash(), sg.label(), -1);
+                areas.at(id).parent = inner.id;
+                inner.insert_subgraph(std::move(sg));
+            }
+            for (uint64_t atom_id : change.moved_atoms) {
+                int i = 0;
+                while (node.atom_ids[i] != atom_id)
+                    i++;
+                std::string atom = node.atoms[i];
+                if (sheet)
+                    change_root(atom_hash(atom), atom, -1);
+                node.remove_atom(i);
+                inner.insert_atom(std::move(atom), atom_id);
+            }
+            cut.update_child(before, inner.contribution());
+            index_area(inner);
+            index_area(cut);
+        }
+
+        for (auto& sg : change.removed_subgraphs) {
+            areas.at(sg.id).detached = false;
+            if (sheet)
+                change_root(sg.hash(), sg.label(), 1);
+            node.insert_subgraph(std::move(sg));
+        }
+        for (size_t i = 0; i < change.removed_atoms.size(); i++) {
+            if (sheet) {
+                change_root(atom_hash(change.removed_atoms[i]),
+                    change.removed_atoms[i], 1);
+            }
+            node.insert_atom(std::move(change.removed_atoms[i]),
+                change.removed_atom_ids[i]);
+        }
+    });
+    return true;
+}
@@ -0,0 +1,87 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef RULE_SITE_INDEX_H_
+#define RULE_SITE_INDEX_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include "./aegraph.h"
+
+// Keeps the double cut, erasure and deiteration sites of a graph up to date
+// while rules are applied to it in place (and undone), so a search step only
+// pays for the part of the graph the rule touched instead of calling the
+// three possible_* enumerators from scratch. The node ids of the graph must
+// be distinct, as they are after parsing or renumber().
+class RuleSiteIndex {
+ public:
+    explicit RuleSiteIndex(AEGraph &graph);
+
+    // same sites as the AEGraph enumerators, in lexicographic order
+    std::vector<std::vector<int>> possible_double_cuts() const;
+    std::vector<std::vector<int>> possible_erasures() const;
+    std::vector<std::vector<int>> possible_deiterations() const;
+
+    // apply the rule to the attached graph and update the sites
+    void double_cut(std::vector<int> where);
+    void erase(std::vector<int> where);
+    void deiterate(std::vector<int> where);
+
+    // reverts the last rule that was applied through the index
+    bool undo();
+
+    const AEGraph& graph() const;
+
+ private:
+    // what the index keeps for a cut, by its id; the double cut and
+    // erasure sites need nothing besides the counts AEGraph keeps
+    struct Area {
+        uint64_t parent;
+        // taken out of the graph by a rule that may still be undone
+        bool detached;
+        // hashes of the elements that could be deiterated (all of them,
+        // when the cut is below the sheet and holds more than one)
+        std::vector<uint64_t> candidates;
+        // the originals on the sheet with the same hash as a candidate in
+        // this subtree, summed over those candidates; a bound on its
+        // deiteration sites, which are confirmed by label
+        int originals;
+    };
+
+    struct Change {
+        std::string rule;
+        // id of the edited area; its path may change when an equal
+        // sibling is undone
+        uint64_t area;
+        // the removed subgraph (the outer cut, emptied, for a double cut)
+        // or atom
+        std::vector<AEGraph> removed_subgraphs;
+        std::vector<std::string> removed_atoms;
+        std::vector<uint64_t> removed_atom_ids;
+        // ids of the elements a double cut moved out of its inner cut
+        std::vector<uint64_t> moved_subgraphs;
+        std::vector<uint64_t> moved_atoms;
+    };
+
+    void index_area(const AEGraph& node);
+    int count_originals(uint64_t hash) const;
+    void change_root(uint64_t hash, const std::string& label, int delta);
+    void propagate(uint64_t id, int delta);
+
+    std::vector<int> path_to(uint64_t id) const;
+    void edit(const std::vector<int>& area,
+        std::function<void(AEGraph&)> change);
+
+    AEGraph &g;
+    std::unordered_map<uint64_t, Area> areas;
+    // the areas holding candidates with a given hash, and how many
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, int>> holders;
+    // the labels (names, for atoms) of the elements of the sheet of
+    // assertion with a given hash, sorted
+    std::unordered_map<uint64_t, std::vector<std::string>> roots;
+    std::vector<Change> history;
+};
+
+#endif  // RULE_SITE_INDEX_H_
@@ -48,7 +48,7 @@ MEMCHECK="valgrind --leak-check=full \
     --show-leak-kinds=all \
     --error-exitcode=100"
 
-for i in `seq 1 7`; do
+for i in `seq 1 32`; do
     echo "Running test $i"
     test_score="`LD_LIBRARY_PATH=.. ./test$i | tail -n1`"
     [[ $? -ne 0 ]] && test_score="0"
@@ -71,7 +71,7 @@ score="`echo "$score" | bc`"
 
 echo "==============================================="
 echo -n "Final score: "
-echo "$score/80"
+echo "$score/330"
 make clean
 
 cd ..
@@ -0,0 +1,117 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "./sat_solver.h"
+
+bool satisfiable(const Clauses& cnf) {
+    // literal 2v is variable v and 2v + 1 its negation; the clauses are
+    // kept without repeated literals, and the tautologies are dropped
+    std::vector<std::vector<int>> clauses;
+    std::vector<int> units;
+    int num_variables = 0;
+    for (const auto& literals : cnf) {
+        std::vector<int> clause;
+        for (int literal : literals) {
+            int variable = literal > 0 ? literal : -literal;
+            num_variables = std::max(num_variables, variable);
+            clause.push_back(2 * variable + (literal < 0));
+        }
+        std::sort(clause.begin(), clause.end());
+        clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+        bool tautology = false;
+        for (size_t k = 1; k < clause.size(); k++) {
+            tautology = tautology || (clause[k] ^ 1) == clause[k - 1];
+        }
+        if (clause.empty())
+            return false;
+        else if (clause.size() == 1)
+            units.push_back(clause[0]);
+        else if (!tautology)
+            clauses.push_back(std::move(clause));
+    }
+
+    // value[v]: -1 if v is unassigned, else whether it is true
+    std::vector<int> value(num_variables + 1, -1);
+    std::vector<int> trail;
+    auto is_false = [&](int literal) {
+        return value[literal >> 1] == (literal & 1);
+    };
+    auto assign = [&](int literal) {
+        value[literal >> 1] = !(literal & 1);
+        trail.push_back(literal);
+    };
+
+    std::vector<std::vector<int>> watches(2 * num_variables + 2);
+    for (size_t c = 0; c < clauses.size(); c++) {
+        watches[clauses[c][0]].push_back(c);
+        watches[clauses[c][1]].push_back(c);
+    }
+    for (int literal : units) {
+        if (is_false(literal))
+            return false;
+        if (value[literal >> 1] == -1)
+            assign(literal);
+    }
+
+    // the decisions, as the size of the trail before each one and whether
+    // its other value was tried already
+    std::vector<std::pair<size_t, bool>> decisions;
+    size_t propagated = 0;
+    while (true) {
+        bool conflict = false;
+        while (propagated < trail.size() && !conflict) {
+            int falsified = trail[propagated++] ^ 1;
+            std::vector<int> &watching = watches[falsified];
+            for (size_t k = 0; k < watching.size() && !conflict; ) {
+                std::vector<int> &c = clauses[watching[k]];
+                if (c[0] == falsified)
+                    std::swap(c[0], c[1]);
+                if (value[c[0] >> 1] == !(c[0] & 1)) {
+                    k++;
+                    continue;
+                }
+
+                size_t other = 2;
+                while (other < c.size() && is_false(c[other]))
+                    other++;
+                if (other < c.size()) {
+                    std::swap(c[1], c[other]);
+                    watches[c[1]].push_back(watching[k]);
+                    watching[k] = watching.back();
+                    watching.pop_back();
+                } else if (value[c[0] >> 1] == -1) {
+                    assign(c[0]);
+                    k++;
+                } else {
+                    conflict = true;
+                }
+            }
+        }
+
+        if (conflict) {
+            while (!decisions.empty() && decisions.back().second)
+                decisions.pop_back();
+            if (decisions.empty())
+                return false;
+            size_t start = decisions.back().first;
+            int literal = trail[start];
+            while (trail.size() > start) {
+                value[trail.back() >> 1] = -1;
+                trail.pop_back();
+            }
+            decisions.back().second = true;
+            assign(literal ^ 1);
+            propagated = start;
+            continue;
+        }
+
+        int variable = 1;
+        while (variable <= num_variables && value[variable] != -1)
+            variable++;
+        if (variable > num_variables)
+            return true;
+        decisions.push_back({trail.size(), false});
+        assign(2 * variable + 1);
+    }
+}
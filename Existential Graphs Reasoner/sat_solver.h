@@ -0,0 +1,15 @@
+// Copyright 2019 Luca Istrate, Danut Matei
+#ifndef SAT_SOLVER_H_
+#define SAT_SOLVER_H_
+
+#include <vector>
+
+// a formula in conjunctive normal form: every clause is a list of nonzero
+// literals, v for variable v and -v for its negation, as in DIMACS
+using Clauses = std::vector<std::vector<int>>;
+
+// whether the clauses are satisfiable: DPLL with unit propagation on two
+// watched literals per clause and chronological backtracking
+bool satisfiable(const Clauses& cnf);
+
+#endif  // SAT_SOLVER_H_